@@ -0,0 +1,34 @@
+/**********************************
+ * FILE NAME: AggregateSource.h
+ *
+ * DESCRIPTION: Interface for the layers that feed the cluster-wide aggregates
+ **********************************/
+
+#ifndef AGGREGATESOURCE_H_
+#define AGGREGATESOURCE_H_
+
+/**
+ * Metrics aggregated over the cluster by push-sum
+ */
+enum AggregateMetric {
+	AGG_LOAD,		// messages handled per tick
+	AGG_KEYS,		// keys stored
+	AGG_REQUESTS,	// client requests per tick
+	AGGREGATES
+};
+
+/**
+ * CLASS NAME: AggregateSource
+ *
+ * DESCRIPTION: Sampled by MP1Node at the start of every aggregation epoch.
+ * 				The counters are totals since the node started, MP1Node turns them into rates.
+ */
+class AggregateSource {
+public:
+	virtual long messagesHandled() = 0;
+	virtual long requestsServed() = 0;
+	virtual long keysStored() = 0;
+	virtual ~AggregateSource() {}
+};
+
+#endif /* AGGREGATESOURCE_H_ */
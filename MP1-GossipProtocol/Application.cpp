@@ -6,6 +6,28 @@
 
 #include "Application.h"
 
+#ifdef ALLOCCHECK
+/*
+ * Allocation checking build (make alloccheck). Every operator new is counted, so that mp1Run
+ * can check that a node of a stable group runs its membership loop without touching the heap.
+ */
+static unsigned long allocations = 0;
+static unsigned long allocatingLoops = 0;
+
+void *operator new(size_t size) {
+	++allocations;
+	void *ptr = malloc(size ? size : 1);
+	if( ptr == NULL ) {
+		throw std::bad_alloc();
+	}
+	return ptr;
+}
+
+void operator delete(void *ptr) noexcept {
+	free(ptr);
+}
+#endif
+
 void handler(int sig) {
 	void *array[10];
 	size_t size;
@@ -101,6 +123,8 @@ int Application::run()
 		mp1Run();
 		// Fail some nodes
 		fail();
+		// Send the test broadcasts
+		broadcast();
 	}
 
 	// Clean up
@@ -110,6 +134,13 @@ int Application::run()
 		 mp1[i]->finishUpThisNode();
 	}
 
+	#ifdef ALLOCCHECK
+	fprintf(stderr, "ALLOCCHECK: %lu steady state node loops allocated\n", allocatingLoops);
+	if( allocatingLoops ) {
+		exit(1);
+	}
+	#endif
+
 	return SUCCESS;
 }
 
@@ -152,7 +183,19 @@ void Application::mp1Run() {
 		 */
 		else if( par->getcurrtime() > (int)(par->STEP_RATE*i) && !(mp1[i]->getMemberNode()->bFailed) ) {
 			// handle messages and send heartbeats
+			#ifdef ALLOCCHECK
+			// Loops that change the membership may allocate, all the others may not
+			bool inGroup = mp1[i]->getMemberNode()->inGroup;
+			long version = mp1[i]->getMembershipVersion();
+			unsigned long before = allocations;
+			#endif
 			mp1[i]->nodeLoop();
+			#ifdef ALLOCCHECK
+			if( inGroup && version == mp1[i]->getMembershipVersion() && allocations != before ) {
+				fprintf(stderr, "ALLOCCHECK: node %d allocated %lu times at time %d\n", i + 1, allocations - before, par->getcurrtime());
+				allocatingLoops++;
+			}
+			#endif
 			#ifdef DEBUGLOG
 			if( (i == 0) && (par->globaltime % 500 == 0) ) {
 				log->LOG(&mp1[i]->getMemberNode()->addr, "@@time=%d", par->getcurrtime());
@@ -163,6 +206,33 @@ void Application::mp1Run() {
 	}
 }
 
+/**
+ * FUNCTION NAME: broadcast
+ *
+ * DESCRIPTION: This function sends the test broadcasts, from a random live node every 20 ticks
+ * 				starting at time 60, so that some of them cross the failures at time 100
+ *
+ * Note: this is used only by MP1
+ */
+void Application::broadcast() {
+	int time = par->getcurrtime();
+	if( time < 60 || (time - 60) % 20 != 0 || (time - 60) / 20 >= par->BROADCASTS ) {
+		return;
+	}
+
+	int sender;
+	do {
+		sender = rand() % par->EN_GPSZ;
+	} while( mp1[sender]->getMemberNode()->bFailed );
+
+	char payload[64];
+	sprintf(payload, "test broadcast %d", (time - 60) / 20);
+	#ifdef DEBUGLOG
+	log->LOG(&mp1[sender]->getMemberNode()->addr, "Broadcast %d sent at time=%d", (time - 60) / 20, time);
+	#endif
+	mp1[sender]->broadcast(payload);
+}
+
 /**
  * FUNCTION NAME: fail
  *
@@ -183,6 +253,9 @@ void Application::fail() {
 		#ifdef DEBUGLOG
 		log->LOG(&mp1[removed]->getMemberNode()->addr, "Node failed at time=%d", par->getcurrtime());
 		#endif
+		if( par->GRACEFUL_LEAVE ) {
+			mp1[removed]->finishUpThisNode();
+		}
 		mp1[removed]->getMemberNode()->bFailed = true;
 	}
 	else if( par->getcurrtime() == 100 ) {
@@ -191,10 +264,25 @@ void Application::fail() {
 			#ifdef DEBUGLOG
 			log->LOG(&mp1[i]->getMemberNode()->addr, "Node failed at time = %d", par->getcurrtime());
 			#endif
+			if( par->GRACEFUL_LEAVE ) {
+				mp1[i]->finishUpThisNode();
+			}
 			mp1[i]->getMemberNode()->bFailed = true;
 		}
 	}
 
+	// bring the failed nodes back
+	if( par->RESTART_AFTER && par->getcurrtime() == 100 + par->RESTART_AFTER ) {
+		for ( i = 0; i < par->EN_GPSZ; i++ ) {
+			if( mp1[i]->getMemberNode()->bFailed ) {
+				#ifdef DEBUGLOG
+				log->LOG(&mp1[i]->getMemberNode()->addr, "Node restarted at time=%d", par->getcurrtime());
+				#endif
+				mp1[i]->nodeStart(JOINADDR, par->PORTNUM);
+			}
+		}
+	}
+
 	if( par->DROP_MSG && par->getcurrtime() == 300) {
 		par->dropmsg=0;
 	}
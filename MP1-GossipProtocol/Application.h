@@ -47,6 +47,7 @@ public:
 	int run();
 	void mp1Run();
 	void fail();
+	void broadcast();
 };
 
 #endif /* _APPLICATION_H__ */
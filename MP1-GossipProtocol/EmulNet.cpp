@@ -23,6 +23,11 @@ EmulNet::EmulNet(Params *p)
 			recv_msgs[i][j] = 0;
 		}
 	}
+	for ( i = 0; i <= MAX_NODES; i++ ) {
+		sent_bytes[i] = 0;
+		recv_bytes[i] = 0;
+	}
+	cross_zone_bytes = 0;
 	//trace.funcExit("EmulNet::EmulNet", SUCCESS);
 }
 
@@ -39,6 +44,11 @@ EmulNet::EmulNet(EmulNet &anotherEmulNet) {
 			this->recv_msgs[i][j] = anotherEmulNet.recv_msgs[i][j];
 		}
 	}
+	for ( i = 0; i <= MAX_NODES; i++ ) {
+		this->sent_bytes[i] = anotherEmulNet.sent_bytes[i];
+		this->recv_bytes[i] = anotherEmulNet.recv_bytes[i];
+	}
+	this->cross_zone_bytes = anotherEmulNet.cross_zone_bytes;
 	this->emulnet = anotherEmulNet.emulnet;
 }
 
@@ -55,6 +65,11 @@ EmulNet& EmulNet::operator =(EmulNet &anotherEmulNet) {
 			this->recv_msgs[i][j] = anotherEmulNet.recv_msgs[i][j];
 		}
 	}
+	for ( i = 0; i <= MAX_NODES; i++ ) {
+		this->sent_bytes[i] = anotherEmulNet.sent_bytes[i];
+		this->recv_bytes[i] = anotherEmulNet.recv_bytes[i];
+	}
+	this->cross_zone_bytes = anotherEmulNet.cross_zone_bytes;
 	this->emulnet = anotherEmulNet.emulnet;
 	return *this;
 }
@@ -93,8 +108,15 @@ int EmulNet::ENsend(Address *myaddr, Address *toaddr, char *data, int size) {
 		return 0;
 	}
 
+	// Addresses may sit at any offset, e.g. packed in a vector<Address>
+	int src, dst;
+	memcpy(&src, myaddr->addr, sizeof(int));
+	memcpy(&dst, toaddr->addr, sizeof(int));
+	int time = par->getcurrtime();
+
 	em = (en_msg *)malloc(sizeof(en_msg) + size);
 	em->size = size;
+	em->deliverAt = time + par->linkLatency(src, dst);
 
 	memcpy(&(em->from.addr), &(myaddr->addr), sizeof(em->from.addr));
 	memcpy(&(em->to.addr), &(toaddr->addr), sizeof(em->from.addr));
@@ -102,13 +124,14 @@ int EmulNet::ENsend(Address *myaddr, Address *toaddr, char *data, int size) {
 
 	emulnet.buff[emulnet.currbuffsize++] = em;
 
-	int src = *(int *)(myaddr->addr);
-	int time = par->getcurrtime();
-
 	assert(src <= MAX_NODES);
 	assert(time < MAX_TIME);
 
 	sent_msgs[src][time]++;
+	sent_bytes[src] += size;
+	if ( par->zoneOf(src) != par->zoneOf(dst) ) {
+		cross_zone_bytes += size;
+	}
 
 	#ifdef DEBUGLOG
 		sprintf(temp, "Sending 4+%d B msg type %d to %d.%d.%d.%d:%d ", size-4, *(int *)data, toaddr->addr[0], toaddr->addr[1], toaddr->addr[2], toaddr->addr[3], *(short *)&toaddr->addr[4]);
@@ -151,7 +174,8 @@ int EmulNet::ENrecv(Address *myaddr, int (* enq)(void *, char *, int), struct ti
 	for( i = emulnet.currbuffsize - 1; i >= 0; i-- ) {
 		emsg = emulnet.buff[i];
 
-		if ( 0 == strcmp(emsg->to.addr, myaddr->addr) ) {
+		// Messages still in flight on a slow link stay in the buffer
+		if ( 0 == strcmp(emsg->to.addr, myaddr->addr) && emsg->deliverAt <= par->getcurrtime() ) {
 			sz = emsg->size;
 			tmp = (char *) malloc(sz * sizeof(char));
 			memcpy(tmp, (char *)(emsg+1), sz);
@@ -163,13 +187,15 @@ int EmulNet::ENrecv(Address *myaddr, int (* enq)(void *, char *, int), struct ti
 
 			free(emsg);
 
-			int dst = *(int *)(myaddr->addr);
+			int dst;
+			memcpy(&dst, myaddr->addr, sizeof(int));
 			int time = par->getcurrtime();
 
 			assert(dst <= MAX_NODES);
 			assert(time < MAX_TIME);
 
 			recv_msgs[dst][time]++;
+			recv_bytes[dst] += sz;
 		}
 	}
 
@@ -212,8 +238,9 @@ int EmulNet::ENcleanup() {
 			}
 		}
 		fprintf(file, "\n");
-		fprintf(file, "node %3d sent_total %6u  recv_total %6u\n\n", i, sent_total, recv_total);
+		fprintf(file, "node %3d sent_total %6u  recv_total %6u  sent_bytes %9ld  recv_bytes %9ld\n\n", i, sent_total, recv_total, sent_bytes[i], recv_bytes[i]);
 	}
+	fprintf(file, "cross_zone_bytes %ld\n", cross_zone_bytes);
 
 	fclose(file);
 	return 0;
@@ -0,0 +1,111 @@
+/**********************************
+ * FILE NAME: FailureDetector.cpp
+ *
+ * DESCRIPTION: Definition of the phi-accrual failure detector
+ **********************************/
+
+#include "FailureDetector.h"
+
+/**
+ * Constructor
+ */
+ArrivalWindow::ArrivalWindow(long now): lastArrival(now), count(0), next(0), sum(0) {}
+
+/**
+ * FUNCTION NAME: add
+ *
+ * DESCRIPTION: Record a heartbeat arrival at time now
+ */
+void ArrivalWindow::add(long now) {
+	if ( now <= lastArrival ) {
+		return;
+	}
+	long interval = now - lastArrival;
+	lastArrival = now;
+	if ( count == PHI_WINDOW ) {
+		sum -= intervals[next];
+	}
+	else {
+		count++;
+	}
+	intervals[next] = interval;
+	sum += interval;
+	next = (next + 1) % PHI_WINDOW;
+}
+
+/**
+ * FUNCTION NAME: mean
+ *
+ * DESCRIPTION: Mean inter-arrival time, never below one tick
+ */
+double ArrivalWindow::mean() {
+	if ( count == 0 ) {
+		return PHI_BOOTSTRAP_INTERVAL;
+	}
+	double m = (double)sum / count;
+	return m < 1.0 ? 1.0 : m;
+}
+
+/**
+ * FUNCTION NAME: heartbeat
+ *
+ * DESCRIPTION: Record a heartbeat of the member identified by key
+ */
+void PhiAccrualDetector::heartbeat(unsigned long long key, long now) {
+	unordered_map<unsigned long long, ArrivalWindow>::iterator it = windows.find(key);
+	if ( it == windows.end() ) {
+		windows.emplace(key, ArrivalWindow(now));
+	}
+	else {
+		it->second.add(now);
+	}
+}
+
+/**
+ * FUNCTION NAME: phi
+ *
+ * DESCRIPTION: Suspicion level of the member identified by key at time now
+ *
+ * RETURNS:
+ * 0 for members that were never heard from
+ */
+double PhiAccrualDetector::phi(unsigned long long key, long now) {
+	unordered_map<unsigned long long, ArrivalWindow>::iterator it = windows.find(key);
+	if ( it == windows.end() ) {
+		return 0;
+	}
+	double elapsed = (double)(now - it->second.lastArrival);
+	return M_LOG10E * elapsed / it->second.mean();
+}
+
+/**
+ * FUNCTION NAME: deadline
+ *
+ * DESCRIPTION: Earliest time at which phi of the member identified by key reaches threshold,
+ * 				assuming no further heartbeat arrives
+ */
+long PhiAccrualDetector::deadline(unsigned long long key, double threshold) {
+	unordered_map<unsigned long long, ArrivalWindow>::iterator it = windows.find(key);
+	if ( it == windows.end() ) {
+		return 0;
+	}
+	return it->second.lastArrival + (long)ceil(threshold * it->second.mean() / M_LOG10E);
+}
+
+/**
+ * FUNCTION NAME: remove
+ *
+ * DESCRIPTION: Forget the arrival history of a member
+ */
+void PhiAccrualDetector::remove(unsigned long long key) {
+	windows.erase(key);
+}
+
+/**
+ * FUNCTION NAME: clear
+ *
+ * DESCRIPTION: Forget the arrival history of all members
+ */
+void PhiAccrualDetector::clear() {
+	windows.clear();
+}
@@ -0,0 +1,147 @@
+#!/usr/bin/env bash
+
+#**********************
+#*
+#* Progam Name: MP1. Membership Protocol.
+#*
+#* Current file: FailureDetectorBench.sh
+#* About this file: Runs the membership protocol over a grid of cluster
+#*                  sizes, message drop probabilities and failure patterns,
+#*                  once per protocol variant, and writes one CSV row per
+#*                  grid point: detection latency distribution, false
+#*                  positives, completeness and bytes sent per node per tick.
+#*
+#* Usage: ./FailureDetectorBench.sh [label:KEY=value,KEY=value ...]
+#*
+#*        Each argument is a protocol variant: a label followed by the
+#*        configuration keys it adds to every test case. The default
+#*        variants are "tremove" (no extra keys) and "phi8:PHI_THRESHOLD=8".
+#*
+#*        The grid is set through the environment:
+#*          SIZES     cluster sizes               (default "10 20 50")
+#*          DROPS     message drop probabilities  (default "0 0.1 0.2")
+#*          PATTERNS  single, multi and/or leave  (default "single multi leave")
+#*          RUNS      runs per grid point         (default 3)
+#*          OUT       report file                 (default fdbench.csv)
+#*
+#***********************
+
+variants=${@:-"tremove phi8:PHI_THRESHOLD=8"}
+SIZES=${SIZES:-"10 20 50"}
+DROPS=${DROPS:-"0 0.1 0.2"}
+PATTERNS=${PATTERNS:-"single multi leave"}
+RUNS=${RUNS:-3}
+OUT=${OUT:-fdbench.csv}
+# TOTAL_RUNNING_TIME in Application.h
+TICKS=700
+
+make > /dev/null || exit 1
+
+# Reads dbg.log and msgcount.log of one run and prints its raw measurements:
+# one "lat" line per detection, then the expected detections, the false
+# positives, the number of correct (alive) pairs and the bytes sent
+function measure () {
+	awk '
+	FILENAME == "msgcount.log" {
+		if ( $3 == "sent_total" ) bytes += $8
+		next
+	}
+	/Node failed at time/ {
+		t = $2; gsub(/[\[\]]/, "", t)
+		failed[$1] = t
+		next
+	}
+	/ joined at time / { nodes[$1] = 1; nodes[$4] = 1 }
+	/ removed at time / {
+		t = $2; gsub(/[\[\]]/, "", t)
+		pair = $1 " " $4
+		if ( $4 in failed ) {
+			if ( !(pair in seen) ) {
+				seen[pair] = 1
+				print "lat", t - failed[$4]
+			}
+		}
+		else {
+			fp++
+		}
+	}
+	END {
+		alive = 0; dead = 0
+		for ( x in nodes ) { if ( x in failed ) dead++; else alive++ }
+		print "expected", alive * dead
+		print "fp", fp + 0
+		print "pairs", alive * (alive - 1)
+		print "bytes", bytes + 0
+	}' dbg.log msgcount.log
+}
+
+# Summarizes the measurements of all runs of one grid point into a CSV row
+function summarize () {
+	awk '
+	$1 == "lat" { lat[++n] = $2; sum += $2 }
+	$1 == "expected" { expected += $2 }
+	$1 == "fp" { fp += $2 }
+	$1 == "pairs" { pairs += $2 }
+	$1 == "bytes" { bytes += $2 }
+	END {
+		for ( i = 2; i <= n; i++ ) {
+			v = lat[i]
+			for ( j = i - 1; j >= 1 && lat[j] > v; j-- ) lat[j + 1] = lat[j]
+			lat[j + 1] = v
+		}
+		printf "%s,%d,%s,%s,%d,%d,%.4f,%.2f,%d,%d,%d,%d,%.6f,%.1f\n",
+			variant, nodes, drop, pattern, expected, n,
+			(expected ? n / expected : 1), (n ? sum / n : 0),
+			(n ? lat[int((n + 1) / 2)] : 0), (n ? lat[int((9 * n + 9) / 10)] : 0), (n ? lat[n] : 0),
+			fp, (pairs ? fp / pairs : 0), bytes / (runs * nodes * ticks)
+	}' variant="$1" nodes="$2" drop="$3" pattern="$4" runs="$RUNS" ticks="$TICKS"
+}
+
+echo "variant,nodes,drop_prob,pattern,expected,detected,completeness,latency_mean,latency_p50,latency_p90,latency_max,false_positives,fp_per_pair,bytes_per_node_tick" > $OUT
+
+conf=`mktemp`
+raw=`mktemp`
+for variant in $variants
+do
+	label=${variant%%:*}
+	keys=""
+	if [ "$variant" != "$label" ]; then
+		keys=${variant#*:}
+	fi
+	for size in $SIZES
+	do
+		for drop in $DROPS
+		do
+			for pattern in $PATTERNS
+			do
+				echo "MAX_NNB: $size" > $conf
+				case $pattern in
+					single) echo "SINGLE_FAILURE: 1" >> $conf ;;
+					multi)  echo "SINGLE_FAILURE: 0" >> $conf ;;
+					leave)  echo "SINGLE_FAILURE: 0" >> $conf
+					        echo "GRACEFUL_LEAVE: 1" >> $conf ;;
+					*)      echo "Unknown failure pattern $pattern" >&2; exit 1 ;;
+				esac
+				if [ "$drop" = "0" ]; then
+					echo "DROP_MSG: 0" >> $conf
+				else
+					echo "DROP_MSG: 1" >> $conf
+				fi
+				echo "MSG_DROP_PROB: $drop" >> $conf
+				for kv in ${keys//,/ }
+				do
+					echo "${kv%%=*}: ${kv#*=}" >> $conf
+				done
+
+				> $raw
+				for (( run = 0; run < RUNS; run++ ))
+				do
+					./Application $conf > /dev/null
+					measure >> $raw
+				done
+				summarize "$label" "$size" "$drop" "$pattern" < $raw | tee -a $OUT
+			done
+		done
+	done
+done
+rm -f $conf $raw
@@ -0,0 +1,75 @@
+#!/usr/bin/env bash
+
+#**********************
+#*
+#* Progam Name: MP1. Membership Protocol.
+#*
+#* Current file: FailureDetectorReport.sh
+#* About this file: Reports detection latency and false positives of the
+#*                  failure detector for the message drop and multi failure
+#*                  test cases, once with the fixed TREMOVE timeout and once
+#*                  per phi-accrual threshold.
+#*
+#* Usage: ./FailureDetectorReport.sh [phi threshold ...]
+#* 
+#***********************
+
+thresholds=${@:-"4 8 12"}
+
+make > /dev/null || exit 1
+
+# Reads dbg.log and prints one report line
+function report () {
+	awk '
+	/Node failed at time/ {
+		t = $2; gsub(/[\[\]]/, "", t)
+		failed[$1] = t
+		next
+	}
+	/ joined at time / { nodes[$1] = 1; nodes[$4] = 1 }
+	/ removed at time / {
+		t = $2; gsub(/[\[\]]/, "", t)
+		pair = $1 " " $4
+		if ( $4 in failed ) {
+			if ( !(pair in seen) ) {
+				seen[pair] = 1
+				lat[++n] = t - failed[$4]
+				sum += t - failed[$4]
+			}
+		}
+		else {
+			fp++
+		}
+	}
+	END {
+		alive = 0; dead = 0
+		for ( x in nodes ) { if ( x in failed ) dead++; else alive++ }
+		for ( i = 2; i <= n; i++ ) {
+			v = lat[i]
+			for ( j = i - 1; j >= 1 && lat[j] > v; j-- ) lat[j + 1] = lat[j]
+			lat[j + 1] = v
+		}
+		mean = n ? sum / n : 0
+		printf "%-8s detected %3d/%-3d  latency mean %6.2f  p50 %4d  max %4d  false positives %3d (%.4f per pair)\n",
+			label, n, alive * dead, mean, n ? lat[int((n + 1) / 2)] : 0, n ? lat[n] : 0,
+			fp, (alive > 1 ? fp / (alive * (alive - 1)) : 0)
+	}' label="$1" dbg.log
+}
+
+for testcase in msgdropsinglefailure multifailure msgdropsingleleave multileave
+do
+	echo "============================================"
+	echo "$testcase"
+	echo "============================"
+	./Application testcases/$testcase.conf > /dev/null
+	report "TREMOVE"
+	for phi in $thresholds
+	do
+		conf=`mktemp`
+		cat testcases/$testcase.conf > $conf
+		echo "PHI_THRESHOLD: $phi" >> $conf
+		./Application $conf > /dev/null
+		report "phi=$phi"
+		rm -f $conf
+	done
+done
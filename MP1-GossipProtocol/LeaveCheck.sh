@@ -0,0 +1,107 @@
+#!/usr/bin/env bash
+
+#**********************
+#*
+#* Progam Name: MP1. Membership Protocol.
+#*
+#* Current file: LeaveCheck.sh
+#* About this file: Runs the graceful leave test cases and checks that every
+#*                  node that left is removed exactly once by every node that
+#*                  stays, and is never added back afterwards.
+#*                  Then runs a test case whose aggressive failure detector
+#*                  removes live nodes, and checks that they refute the removal
+#*                  and are added back within TREMOVE ticks.
+#*
+#* Usage: ./LeaveCheck.sh [test case ...]
+#*
+#***********************
+
+cases=${@:-"testcases/multileave.conf testcases/msgdropsingleleave.conf"}
+falseremoval="testcases/falseremoval.conf"
+# TREMOVE in MP1Node.h
+tremove=20
+
+make > /dev/null || exit 1
+
+# Reads dbg.log and prints the number of (observer, departed node) pairs
+# removed exactly once, the number of pairs expected, and the number of
+# joins of a departed node after it left
+function check () {
+	awk '
+	/Node failed at time/ {
+		t = $2; gsub(/[\[\]]/, "", t)
+		left[$1] = t
+		next
+	}
+	/ joined at time / {
+		nodes[$1] = 1; nodes[$4] = 1
+		t = $2; gsub(/[\[\]]/, "", t)
+		if ( ($4 in left) && !($1 in left) && t + 0 >= left[$4] + 0 ) rejoins++
+	}
+	/ removed at time / { removed[$1 " " $4]++ }
+	END {
+		expected = 0; once = 0
+		for ( o in nodes ) {
+			if ( o in left ) continue
+			for ( d in left ) {
+				expected++
+				if ( removed[o " " d] == 1 ) once++
+			}
+		}
+		print once, expected, rejoins + 0
+	}' dbg.log
+}
+
+# Reads dbg.log and prints the number of removals of nodes that never left,
+# and how many of those made at least TREMOVE ticks before the end of the run
+# were not followed by the node being added back within TREMOVE ticks
+function check_refutation () {
+	# The first pass collects the nodes that left, their removal may be logged first
+	awk -v tremove=$tremove '
+	NR == FNR { if ( /Node failed at time/ ) left[$1] = 1; next }
+	{ t = $2; gsub(/[\[\]]/, "", t); if ( t + 0 > end ) end = t + 0 }
+	/ removed at time / {
+		if ( !($4 in left) ) { removals++; since[$1 " " $4] = t + 0 }
+		next
+	}
+	/ joined at time / {
+		k = $1 " " $4
+		if ( (k in since) && t - since[k] > tremove ) late++
+		delete since[k]
+	}
+	END {
+		for ( k in since ) if ( since[k] + tremove <= end ) late++
+		print removals + 0, late + 0
+	}' dbg.log dbg.log
+}
+
+status=0
+for conf in $cases
+do
+	./Application $conf > /dev/null
+	read once expected rejoins <<< "`check`"
+	echo "$conf"
+	if [ $once -eq $expected ] && [ $expected -gt 0 ]; then
+		echo "Checking Single Removal........OK ($once/$expected)"
+	else
+		echo "Checking Single Removal........FAIL ($once/$expected)"
+		status=1
+	fi
+	if [ $rejoins -eq 0 ]; then
+		echo "Checking No Rejoin.............OK"
+	else
+		echo "Checking No Rejoin.............FAIL ($rejoins joins)"
+		status=1
+	fi
+done
+
+./Application $falseremoval > /dev/null
+read removals late <<< "`check_refutation`"
+echo "$falseremoval"
+if [ $removals -gt 0 ] && [ $late -eq 0 ]; then
+	echo "Checking Refuted Removal.......OK ($removals removals)"
+else
+	echo "Checking Refuted Removal.......FAIL ($late of $removals removals not refuted)"
+	status=1
+fi
+exit $status
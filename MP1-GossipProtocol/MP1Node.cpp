@@ -16,7 +16,7 @@
  * You can add new members to the class if you think it
  * is necessary for your logic to work
  */
-MP1Node::MP1Node(Member *member, Params *params, EmulNet *emul, Log *log, Address *address) {
+MP1Node::MP1Node(Member *member, Params *params, EmulNet *emul, Log *log, Address *address): tombstones(TOMBSTONE_LIMIT), membersDigest(0), membershipVersion(0), joinAttempts(0), joinDeadline(-1), windowCursor(0), recentHead(0), snapshot(string("mp1node_") + address->getAddress() + ".snapshot"), aggEpoch(-1), aggWeight(0), aggSource(NULL), messagesHandled(0), epochMessages(0), epochRequests(0), epochStart(0), plumtree(PLUMTREE_VIEW), broadcastSeq(0) {
 	for( int i = 0; i < 6; i++ ) {
 		NULLADDR[i] = 0;
 	}
@@ -25,6 +25,21 @@ MP1Node::MP1Node(Member *member, Params *params, EmulNet *emul, Log *log, Addres
 	this->log = log;
 	this->par = params;
 	this->memberNode->addr = *address;
+	this->sendBuffer.resize(sizeof(MessageHdr) + params->EN_GPSZ * sizeof(MessageEntry));
+	this->window.reserve(params->EN_GPSZ);
+	this->memberNode->memberList.reserve(params->EN_GPSZ);
+	this->snapshot.reserve(params->EN_GPSZ);
+	this->plumtree.reserve(params->EN_GPSZ, PLUMTREE_MESSAGES, maxBroadcastPayload());
+	this->grafts.reserve(PLUMTREE_MESSAGES);
+	// A snapshot left behind by an earlier run of the emulator belongs to another group
+	if( params->SNAPSHOT_INTERVAL > 0 ) {
+		this->snapshot.remove();
+	}
+	this->recentChanges.assign(RECENT_CHANGES, make_pair(0ULL, -1L));
+	for( int m = 0; m < AGGREGATES; m++ ) {
+		this->aggSum[m] = 0;
+		this->aggAverage[m] = 0;
+	}
 }
 
 /**
@@ -105,9 +120,20 @@ int MP1Node::initThisNode(Address *joinaddr) {
     // node is up!
 	memberNode->nnb = 0;
 	memberNode->heartbeat = 0;
+	// heartbeats restart from zero, the new incarnation tells peers they are still fresh
+	++(memberNode->incarnation);
 	memberNode->pingCounter = TFAIL;
 	memberNode->timeOutCounter = -1;
+	joinAttempts = 0;
+	joinDeadline = -1;
+	// The first epoch takes its rates from now on
+	aggEpoch = -1;
+	aggWeight = 0;
+	epochMessages = messagesHandled + (aggSource ? aggSource->messagesHandled() : 0);
+	epochRequests = aggSource ? aggSource->requestsServed() : 0;
+	epochStart = this->par->getcurrtime();
     initMemberListTable(memberNode);
+    restoreSnapshot();
 
     return 0;
 }
@@ -118,11 +144,15 @@ int MP1Node::initThisNode(Address *joinaddr) {
  * DESCRIPTION: Join the distributed system
  */
 int MP1Node::introduceSelfToGroup(Address *joinaddr) {
-	MessageHdr *msg;
 #ifdef DEBUGLOG
     static char s[1024];
 #endif
 
+    // Resumed from a snapshot, the members are pinged directly
+    if ( memberNode->inGroup ) {
+        return 1;
+    }
+
     if ( 0 == memcmp((char *)&(memberNode->addr.addr), (char *)&(joinaddr->addr), sizeof(memberNode->addr.addr))) {
         // I am the group booter (first process to join the group). Boot up the group
 #ifdef DEBUGLOG
@@ -131,21 +161,15 @@ int MP1Node::introduceSelfToGroup(Address *joinaddr) {
         memberNode->inGroup = true;
     }
     else {
-        // create JOINREQ message: format of data is {struct Address myaddr}
-        msg = new MessageHdr();
-        msg->msgType = JOINREQ;
-        msg->memberList = memberNode->memberList;
-        msg->addr = &memberNode->addr;
-
 #ifdef DEBUGLOG
         sprintf(s, "Trying to join...");
         log->LOG(&memberNode->addr, s);
 #endif
 
-        // send JOINREQ message to introducer member
-        emulNet->ENsend(&memberNode->addr, joinaddr, (char *)msg, sizeof(MessageHdr));
-
-        free(msg);
+        // send JOINREQ message to introducer member, another one is tried if no JOINREP arrives in TJOIN
+        vector<MemberListEntry> noEntries;
+        sendMessage(joinaddr, JOINREQ, noEntries);
+        joinDeadline = this->par->getcurrtime() + TJOIN;
     }
 
     return 1;
@@ -158,9 +182,29 @@ int MP1Node::introduceSelfToGroup(Address *joinaddr) {
  * DESCRIPTION: Wind up this node and clean up state
  */
 int MP1Node::finishUpThisNode(){
-   /*
-    * Your code goes here
-    */
+    if(memberNode->bFailed || !memberNode->inGroup)
+        return 0;
+
+    // Announce the departure instead of letting everybody time out
+    int id = 0;
+    short port;
+    memcpy(&id, &memberNode->addr.addr[0], sizeof(int));
+    memcpy(&port, &memberNode->addr.addr[4], sizeof(short));
+    MemberListEntry self(id, port, memberNode->heartbeat, this->par->getcurrtime());
+    self.incarnation = memberNode->incarnation;
+    vector<MemberListEntry> leaving(1, self);
+
+    int num_members = memberNode->memberList.size();
+    for (int i = 0; i < num_members; ++i) {
+        Address address = getAddress(memberNode->memberList.id(i), memberNode->memberList.port(i));
+        sendMessage(&address, LEAVE, leaving);
+    }
+
+    memberNode->inGroup = false;
+    joinDeadline = -1;
+    initMemberListTable(memberNode);
+    pendingLeaves.clear();
+    return 0;
 }
 
 /**
@@ -179,6 +223,11 @@ void MP1Node::nodeLoop() {
 
     // Wait until you're in the group...
     if( !memberNode->inGroup ) {
+        if( joinDeadline >= 0 && this->par->getcurrtime() >= joinDeadline ) {
+            ++joinAttempts;
+            Address joinaddr = getJoinAddress();
+            introduceSelfToGroup(&joinaddr);
+        }
     	return;
     }
 
@@ -214,16 +263,37 @@ void MP1Node::checkMessages() {
  */
 bool MP1Node::recvCallBack(void *env, char *data, int size ) {
     MessageHdr* msg = (MessageHdr*) data;
+    if(size < (int)sizeof(MessageHdr) || size < (int)(sizeof(MessageHdr) + msg->numEntries * sizeof(MessageEntry))) {
+        free(data);
+        return false;
+    }
+    ++messagesHandled;
+    mergeAggregateShare(msg);
+
     if(msg->msgType == JOINREQ) {
-        AddToMemberList(msg);
-        sendMessage(msg->addr, JOINREP);
+        // Introducers still joining themselves stay silent, the joiner moves on to another one
+        if(memberNode->inGroup) {
+            AddToMemberList(msg);
+            Address source = senderAddress(msg);
+            sendJoinReply(&source);
+        }
     } else if(msg->msgType == JOINREP) {
+        // The JOINREPs carry the introducer's whole memberList, so the whole group is known at once
         AddToMemberList(msg);
+        mergeMemberList(msg);
         memberNode->inGroup = true;
+        joinDeadline = -1;
     } else if(msg->msgType == PING) {
         pingHandler(msg);
+    } else if(msg->msgType == LEAVE) {
+        leaveHandler(msg);
+    } else if(msg->msgType == SYNC || msg->msgType == SYNCREP) {
+        syncHandler(msg);
+    } else if(msg->msgType >= BCAST && msg->msgType <= PRUNE) {
+        broadcastHandler(msg, size);
     }
-    delete msg;
+    // The buffer was malloc'ed by EmulNet::ENrecv
+    free(data);
     return true;
 }
 
@@ -237,27 +307,51 @@ bool MP1Node::recvCallBack(void *env, char *data, int size ) {
 void MP1Node::nodeLoopOps() {
     ++(memberNode->heartbeat);
 
-    for(int i = memberNode->memberList.size()-1; i >= 0; --i){
-        int id = memberNode->memberList[i].id;
-        short port = memberNode->memberList[i].port;
-        long timestamp = memberNode->memberList[i].timestamp;
+    tombstones.expire(this->par->getcurrtime());
 
-        if(this->par->getcurrtime() - timestamp >= TREMOVE) {
-            Address* addressToRemove = getAddress(id, port);
-            log->logNodeRemove(&memberNode->addr, addressToRemove);
-            memberNode->memberList.erase(memberNode->memberList.begin()+i);
-            delete addressToRemove;
+    long epoch = this->par->getcurrtime() / TAGGREGATE;
+    if(epoch != aggEpoch)
+        startAggregateEpoch(epoch);
+
+    if(this->par->SNAPSHOT_INTERVAL > 0 && this->par->getcurrtime() % this->par->SNAPSHOT_INTERVAL == 0)
+        snapshot.write(memberNode->memberList, memberNode->incarnation, this->par->getcurrtime());
+
+    // Only the members whose expiry timer fired this tick are looked at
+    expired.clear();
+    expiry.advance(this->par->getcurrtime(), expired);
+    for(size_t i = 0; i < expired.size(); ++i) {
+        unordered_map<unsigned long long, int>::iterator it = memberIndex.find(expired[i]);
+        if(it == memberIndex.end())
+            continue;
+        if(hasFailed(it->second)) {
+            removeMember(it->second);
+        } else {
+            expiry.schedule(expired[i], expiryTime(it->second));
         }
     }
 
+    // Pings only carry the membership digest, entries follow in a SYNC when the digests differ
+    vector<MemberListEntry> noEntries;
     int num_members = memberNode->memberList.size();
-    for (int i = 0; i < num_members; ++i) {
-        int id = memberNode->memberList[i].id;
-        short port = memberNode->memberList[i].port;
-        Address* address = getAddress(id, port);
-        sendMessage(address, PING);
-        delete address;
+    if(this->par->HIERARCHICAL && this->par->ZONES > 1) {
+        zoneGossip(noEntries);
+    } else {
+        // One ping a round carries half of the push-sum mass
+        int pushTarget = num_members > 0 ? rand() % num_members : -1;
+        for (int i = 0; i < num_members; ++i) {
+            Address address = getAddress(memberNode->memberList.id(i), memberNode->memberList.port(i));
+            sendMessage(&address, PING, noEntries, i == pushTarget);
+        }
     }
+    if(!pendingLeaves.empty()) {
+        for (int i = 0; i < num_members; ++i) {
+            Address address = getAddress(memberNode->memberList.id(i), memberNode->memberList.port(i));
+            sendMessage(&address, LEAVE, pendingLeaves);
+        }
+    }
+    pendingLeaves.clear();
+
+    broadcastTick();
 
     return;
 }
@@ -274,13 +368,24 @@ int MP1Node::isNullAddress(Address *addr) {
 /**
  * FUNCTION NAME: getJoinAddress
  *
- * DESCRIPTION: Returns the Address of the coordinator
+ * DESCRIPTION: Returns the Address of the introducer to send the next join request to.
+ * 				Nodes 1..INTRODUCERS are introducers. Other nodes are spread over them by id,
+ * 				and an introducer joins through the ones started before it. Node 1 boots the group.
  */
 Address MP1Node::getJoinAddress() {
     Address joinaddr;
+    int id = 0;
+    memcpy(&id, &memberNode->addr.addr[0], sizeof(int));
+
+    int introducers = this->par->INTRODUCERS > 0 ? this->par->INTRODUCERS : 1;
+    int introducer = 1;
+    if(id > introducers)
+        introducer = 1 + (id + joinAttempts) % introducers;
+    else if(id > 1)
+        introducer = 1 + joinAttempts % (id - 1);
 
     memset(&joinaddr, 0, sizeof(Address));
-    *(int *)(&joinaddr.addr) = 1;
+    *(int *)(&joinaddr.addr) = introducer;
     *(short *)(&joinaddr.addr[4]) = 0;
 
     return joinaddr;
@@ -292,7 +397,51 @@ Address MP1Node::getJoinAddress() {
  * DESCRIPTION: Initialize the membership list
  */
 void MP1Node::initMemberListTable(Member *memberNode) {
+	for( size_t i = 0; i < memberNode->memberList.size(); i++ ) {
+		notifyLeft(memberNode->memberList.id(i), memberNode->memberList.port(i));
+	}
 	memberNode->memberList.clear();
+	memberIndex.clear();
+	membersDigest = 0;
+	detector.clear();
+	tombstones.clear();
+	expiry.clear(this->par->getcurrtime());
+	plumtree.clear();
+}
+
+/**
+ * FUNCTION NAME: restoreSnapshot
+ *
+ * DESCRIPTION: Load the membership table saved before the node went down, if there is one.
+ * 				The members are suspects: they are removed in TFAIL ticks unless they are heard from.
+ * 				With a PHI_THRESHOLD they are stamped now and the detector judges them like new members,
+ * 				an older stamp would put their phi past the threshold before anyone could answer.
+ * 				The node is in the group right away and gossips with them instead of joining again.
+ */
+void MP1Node::restoreSnapshot() {
+    if(this->par->SNAPSHOT_INTERVAL <= 0)
+        return;
+
+    vector<MemberListEntry> entries;
+    long incarnation, time;
+    if(!snapshot.read(entries, incarnation, time))
+        return;
+
+    // Heartbeats restart from zero, so peers must see an incarnation past the saved one
+    if(memberNode->incarnation <= incarnation)
+        memberNode->incarnation = incarnation + 1;
+
+    long suspect = this->par->getcurrtime();
+    if(this->par->PHI_THRESHOLD <= 0)
+        suspect -= TREMOVE - TFAIL;
+    for(size_t i = 0; i < entries.size(); ++i) {
+        entries[i].timestamp = suspect;
+        AddToMemberList(&entries[i]);
+    }
+    memberNode->inGroup = true;
+#ifdef DEBUGLOG
+    log->LOG(&memberNode->addr, "Restored %d members from the snapshot of time %ld", (int)entries.size(), time);
+#endif
 }
 
 /**
@@ -315,15 +464,32 @@ void MP1Node::AddToMemberList(MessageHdr* msg) {
     cout << "AddToMemberList: msg" << endl;
     int id = 0;
     short port;
-    memcpy(&id, &msg->addr->addr[0], sizeof(int));
-    memcpy(&port, &msg->addr->addr[4], sizeof(short));
+    memcpy(&id, &msg->addr[0], sizeof(int));
+    memcpy(&port, &msg->addr[4], sizeof(short));
 
-    if(checkMemberList(id, port) != nullptr)
+    if(checkMemberList(id, port) >= 0)
         return;
 
-    MemberListEntry memberListEntry(id, port, 1, this->par->getcurrtime());
+    // Only a newer incarnation of the node overrides its tombstone: a message sent
+    // before its leave or removal may still be in flight. The node is told it was
+    // removed, if it is still alive it refutes with a new incarnation (see leaveHandler).
+    unsigned long long key = memberKey(id, port);
+    if(tombstones.buries(key, msg->incarnation)) {
+        notifyRemoved(id, port, msg->heartbeat, msg->incarnation);
+        return;
+    }
+    tombstones.remove(key);
+
+    MemberListEntry memberListEntry(id, port, msg->heartbeat, this->par->getcurrtime());
+    memberListEntry.incarnation = msg->incarnation;
+    membersDigest ^= entryDigest(id, port, memberListEntry.incarnation);
+    memberIndex[memberKey(id, port)] = memberNode->memberList.size();
     memberNode->memberList.push_back(memberListEntry);
-    log->logNodeAdd(&memberNode->addr, msg->addr);
+    refreshMember(memberNode->memberList.size() - 1, this->par->getcurrtime());
+    noteChange(id, port);
+    Address source = senderAddress(msg);
+    log->logNodeAdd(&memberNode->addr, &source);
+    notifyJoined(id, port);
 }
 
 /**
@@ -333,31 +499,39 @@ void MP1Node::AddToMemberList(MessageHdr* msg) {
  */
 void MP1Node::AddToMemberList(MemberListEntry* memberListEntry) {
     cout << "AddToMemberList: MemberListEntry" << endl;
-    Address* addr = getAddress(memberListEntry->id, memberListEntry->port);
-    if(*addr == memberNode->addr) {
-        delete addr;
+    Address addr = getAddress(memberListEntry->id, memberListEntry->port);
+    if(addr == memberNode->addr)
+        return;
+
+    // Removals win over stale gossip about the same incarnation. Fresh gossip may mean the member
+    // was removed while alive, it is told so that it can refute
+    if(tombstones.buries(memberKey(memberListEntry->id, memberListEntry->port), memberListEntry->incarnation)) {
+        if(this->par->getcurrtime() - memberListEntry->timestamp <= TFAIL)
+            notifyRemoved(memberListEntry->id, memberListEntry->port, memberListEntry->heartbeat, memberListEntry->incarnation);
         return;
     }
 
     if(this->par->getcurrtime() - memberListEntry->timestamp < TREMOVE) {
-        log->logNodeAdd(&memberNode->addr, addr);
+        log->logNodeAdd(&memberNode->addr, &addr);
+        membersDigest ^= entryDigest(memberListEntry->id, memberListEntry->port, memberListEntry->incarnation);
+        memberIndex[memberKey(memberListEntry->id, memberListEntry->port)] = memberNode->memberList.size();
         memberNode->memberList.push_back(*memberListEntry);
+        refreshMember(memberNode->memberList.size() - 1, memberListEntry->timestamp);
+        noteChange(memberListEntry->id, memberListEntry->port);
+        notifyJoined(memberListEntry->id, memberListEntry->port);
     }
 }
 
 /**
  * FUNCTION NAME: checkMemberList
  *
- * DESCRIPTION: If the node exists in the memberList, the function will return true. Otherwise, the function will return false.
+ * DESCRIPTION: If the node exists in the memberList, the function will return its index. Otherwise, the function will return -1.
  */
-MemberListEntry* MP1Node::checkMemberList(int id, short port) {
-    int num_members = memberNode->memberList.size();
-    for(int i=0; i<num_members; ++i){
-        if(memberNode->memberList[i].id == id && memberNode->memberList[i].port == port){
-            return &memberNode->memberList[i];
-        }
-    }
-    return nullptr;
+int MP1Node::checkMemberList(int id, short port) {
+    unordered_map<unsigned long long, int>::iterator it = memberIndex.find(memberKey(id, port));
+    if(it == memberIndex.end())
+        return -1;
+    return it->second;
 }
 
 /**
@@ -366,61 +540,829 @@ MemberListEntry* MP1Node::checkMemberList(int id, short port) {
  * DESCRIPTION: sends message using EmulNet
  */
 void MP1Node::sendMessage(Address* toAddress, MsgTypes msgType) {
-    MessageHdr* msg = new MessageHdr();
+    sendMessage(toAddress, msgType, gossipEntries());
+}
+
+/**
+ * FUNCTION NAME: sendMessage
+ *
+ * DESCRIPTION: sends message carrying the given entries using EmulNet.
+ * 				The message is serialized into sendBuffer, which only grows with the group.
+ */
+void MP1Node::sendMessage(Address* toAddress, MsgTypes msgType, const vector<MemberListEntry>& entries, bool pushShare) {
+    size_t size = sizeof(MessageHdr) + entries.size() * sizeof(MessageEntry);
+    if(sendBuffer.size() < size)
+        sendBuffer.resize(size);
+
+    MessageHdr* msg = (MessageHdr*) &sendBuffer[0];
+    writeHeader(msg, msgType, entries.size(), pushShare);
+
+    MessageEntry* messageEntries = (MessageEntry*) (msg + 1);
+    for(int i = 0; i < msg->numEntries; ++i) {
+        messageEntries[i].id = entries[i].id;
+        messageEntries[i].port = entries[i].port;
+        messageEntries[i].heartbeat = entries[i].heartbeat;
+        messageEntries[i].incarnation = entries[i].incarnation;
+        messageEntries[i].timestamp = entries[i].timestamp;
+    }
+    emulNet->ENsend(&memberNode->addr, toAddress, &sendBuffer[0], size);
+}
+
+/**
+ * FUNCTION NAME: sendJoinReply
+ *
+ * DESCRIPTION: Send the whole memberList to a joiner, not just a gossip window. It is split over as many
+ * 				JOINREP messages as needed to keep each one within maxGossipEntries entries.
+ */
+void MP1Node::sendJoinReply(Address* toAddress) {
+    int limit = maxGossipEntries();
+    int num_members = memberNode->memberList.size();
+    int first = 0;
+    // The gossip window is free between two messages
+    do {
+        window.clear();
+        for(int i = first; i < num_members && i < first + limit; ++i)
+            window.push_back(memberNode->memberList.at(i));
+        sendMessage(toAddress, JOINREP, window);
+        first += limit;
+    } while(first < num_members);
+}
+
+/**
+ * FUNCTION NAME: writeHeader
+ *
+ * DESCRIPTION: Fill in the header of an outgoing message.
+ * 				With pushShare the message also carries half of our push-sum mass.
+ */
+void MP1Node::writeHeader(MessageHdr* msg, MsgTypes msgType, int numEntries, bool pushShare) {
     msg->msgType = msgType;
-    msg->memberList = memberNode->memberList;
-    msg->addr = &memberNode->addr;
-    emulNet->ENsend(msg->addr, toAddress, (char*)msg, sizeof(MessageHdr));
+    memcpy(msg->addr, memberNode->addr.addr, sizeof(msg->addr));
+    msg->heartbeat = memberNode->heartbeat;
+    msg->incarnation = memberNode->incarnation;
+    msg->digest = membershipDigest();
+    msg->numEntries = numEntries;
+    msg->aggEpoch = aggEpoch;
+    msg->aggWeight = 0;
+    for(int m = 0; m < AGGREGATES; ++m)
+        msg->aggSum[m] = 0;
+    if(pushShare && aggWeight > 0) {
+        // Sums and weight are halved together, so the estimate sum / weight holds on both sides
+        aggWeight /= 2;
+        msg->aggWeight = aggWeight;
+        for(int m = 0; m < AGGREGATES; ++m) {
+            aggSum[m] /= 2;
+            msg->aggSum[m] = aggSum[m];
+        }
+    }
+}
+
+/**
+ * FUNCTION NAME: maxGossipEntries
+ *
+ * DESCRIPTION: Number of entries a gossip message may carry: GOSSIP_ENTRIES when set,
+ * 				and never more than fit in MAX_MSG_SIZE
+ */
+int MP1Node::maxGossipEntries() {
+    int limit = (this->par->MAX_MSG_SIZE - 1 - (int)sizeof(en_msg) - (int)sizeof(MessageHdr)) / (int)sizeof(MessageEntry);
+    if(this->par->GOSSIP_ENTRIES > 0 && this->par->GOSSIP_ENTRIES < limit)
+        limit = this->par->GOSSIP_ENTRIES;
+    return limit;
+}
+
+/**
+ * FUNCTION NAME: maxBroadcastPayload
+ *
+ * DESCRIPTION: Number of payload bytes a message of the broadcast tree may carry in MAX_MSG_SIZE
+ */
+int MP1Node::maxBroadcastPayload() {
+    return this->par->MAX_MSG_SIZE - 1 - (int)sizeof(en_msg) - (int)sizeof(MessageHdr) - (int)sizeof(BroadcastHdr);
+}
+
+/**
+ * FUNCTION NAME: gossipEntries
+ *
+ * DESCRIPTION: Entries to gossip in the next message. The whole memberList if it fits, otherwise a window of
+ * 				maxGossipEntries entries: members changed in the last TFAIL ticks first, then the memberList round robin.
+ * 				Recent changes take at most half of the window, so every entry is sent within
+ * 				ceil(N / (M - M/2)) messages for N members and a window of M.
+ */
+const vector<MemberListEntry>& MP1Node::gossipEntries() {
+    int limit = maxGossipEntries();
+    int num_members = memberNode->memberList.size();
+    window.clear();
+    if(num_members <= limit) {
+        for(int i = 0; i < num_members; ++i)
+            window.push_back(memberNode->memberList.at(i));
+        return window;
+    }
+
+    long now = this->par->getcurrtime();
+    for(int i = 1; i <= RECENT_CHANGES && (int)window.size() < limit / 2; ++i) {
+        pair<unsigned long long, long>& change = recentChanges[(recentHead + RECENT_CHANGES - i) % RECENT_CHANGES];
+        // The ring is in time order, everything further back is older still
+        if(change.second < 0 || now - change.second > TFAIL)
+            break;
+        unordered_map<unsigned long long, int>::iterator it = memberIndex.find(change.first);
+        if(it != memberIndex.end())
+            window.push_back(memberNode->memberList.at(it->second));
+    }
+    while((int)window.size() < limit) {
+        if(windowCursor >= num_members)
+            windowCursor = 0;
+        window.push_back(memberNode->memberList.at(windowCursor++));
+    }
+    return window;
+}
+
+/**
+ * FUNCTION NAME: noteChange
+ *
+ * DESCRIPTION: Remember that the member was added or changed incarnation, so that it goes first in gossip windows
+ */
+void MP1Node::noteChange(int id, short port) {
+    recentChanges[recentHead] = make_pair(memberKey(id, port), (long)this->par->getcurrtime());
+    recentHead = (recentHead + 1) % RECENT_CHANGES;
+}
+
+/**
+ * FUNCTION NAME: zoneGossip
+ *
+ * DESCRIPTION: Gossip round of the hierarchical mode, used when the nodes are placed in ZONES zones.
+ * 				Members of our own zone are pinged every tick. Across zones only the zone leaders talk,
+ * 				the lowest id of a zone that is not suspected. Every CROSS_ZONE_INTERVAL ticks a leader
+ * 				sends the entries of its zone to the ZONE_GATEWAYS lowest ids of every other zone, which
+ * 				answer with the entries of theirs, and relays the entries of the other zones to its own zone.
+ */
+void MP1Node::zoneGossip(const vector<MemberListEntry>& noEntries) {
+    int self = 0;
+    memcpy(&self, &memberNode->addr.addr[0], sizeof(int));
+    int zone = this->par->zoneOf(self);
+    long now = this->par->getcurrtime();
+    // Entries from other zones are refreshed once per exchange and relay, so they may be that much older
+    long foreignSilence = TFAIL + 2 * this->par->CROSS_ZONE_INTERVAL + this->par->CROSS_ZONE_LATENCY;
+
+    zoneGateways.assign(this->par->ZONES * ZONE_GATEWAYS, -1);
+    bool leader = true;
+    int recipients = 0;
+    int num_members = memberNode->memberList.size();
+    for (int i = 0; i < num_members; ++i) {
+        int id = memberNode->memberList.id(i);
+        int memberZone = this->par->zoneOf(id);
+        long silence = now - memberNode->memberList.timestamp(i);
+        if(memberZone == zone) {
+            ++recipients;
+            if(id < self && silence <= TFAIL)
+                leader = false;
+        } else if(silence <= foreignSilence) {
+            // Insert into the zone's slots, which hold the lowest ids in increasing order
+            int *slots = &zoneGateways[memberZone * ZONE_GATEWAYS];
+            int candidate = i;
+            for (int s = 0; s < ZONE_GATEWAYS && candidate >= 0; ++s) {
+                if(slots[s] < 0 || memberNode->memberList.id(candidate) < memberNode->memberList.id(slots[s]))
+                    swap(slots[s], candidate);
+            }
+        }
+    }
+
+    bool exchange = leader && now % this->par->CROSS_ZONE_INTERVAL == 0;
+    if(exchange) {
+        for (size_t s = 0; s < zoneGateways.size(); ++s) {
+            if(zoneGateways[s] >= 0)
+                ++recipients;
+        }
+    }
+    // One message a round carries half of the push-sum mass, across zones only through the leaders
+    int pushTarget = recipients > 0 ? rand() % recipients : -1;
+    int sent = 0;
+
+    const vector<MemberListEntry>& relayed = exchange ? zoneEntries(zone, false) : noEntries;
+    for (int i = 0; i < num_members; ++i) {
+        if(this->par->zoneOf(memberNode->memberList.id(i)) != zone)
+            continue;
+        Address address = getAddress(memberNode->memberList.id(i), memberNode->memberList.port(i));
+        sendMessage(&address, exchange ? SYNC : PING, relayed, sent++ == pushTarget);
+    }
+    if(!exchange)
+        return;
+    const vector<MemberListEntry>& local = zoneEntries(zone, true);
+    for (size_t s = 0; s < zoneGateways.size(); ++s) {
+        if(zoneGateways[s] < 0)
+            continue;
+        Address address = getAddress(memberNode->memberList.id(zoneGateways[s]), memberNode->memberList.port(zoneGateways[s]));
+        sendMessage(&address, SYNC, local, sent++ == pushTarget);
+    }
+}
+
+/**
+ * FUNCTION NAME: zoneEntries
+ *
+ * DESCRIPTION: Entries of the members inside the zone, or outside of it, to gossip in the next message.
+ * 				When they do not fit in maxGossipEntries they are taken round robin from the memberList.
+ */
+const vector<MemberListEntry>& MP1Node::zoneEntries(int zone, bool inside) {
+    int limit = maxGossipEntries();
+    int num_members = memberNode->memberList.size();
+    window.clear();
+    int start = windowCursor < num_members ? windowCursor : 0;
+    for (int n = 0; n < num_members && (int)window.size() < limit; ++n) {
+        int i = (start + n) % num_members;
+        if((this->par->zoneOf(memberNode->memberList.id(i)) == zone) == inside) {
+            window.push_back(memberNode->memberList.at(i));
+            windowCursor = i + 1;
+        }
+    }
+    return window;
+}
+
+/**
+ * FUNCTION NAME: startAggregateEpoch
+ *
+ * DESCRIPTION: Publish the averages of the push-sum epoch that ended and start the next one
+ * 				from the local values: the load and request rates over the last epoch, and the keys stored.
+ * 				Epochs are TAGGREGATE ticks long, so values that change and mass lost with dropped
+ * 				messages only skew one epoch.
+ */
+void MP1Node::startAggregateEpoch(long epoch) {
+    if(aggEpoch >= 0 && aggWeight > 0) {
+        for(int m = 0; m < AGGREGATES; ++m)
+            aggAverage[m] = aggSum[m] / aggWeight;
+#ifdef DEBUGLOG
+        log->LOG(&memberNode->addr, "Aggregates of epoch %ld: load %.2f keys %.2f requests %.2f per node, %d nodes",
+            aggEpoch, aggAverage[AGG_LOAD], aggAverage[AGG_KEYS], aggAverage[AGG_REQUESTS], (int)memberNode->memberList.size() + 1);
+#endif
+    }
+
+    long now = this->par->getcurrtime();
+    long messages = messagesHandled + (aggSource ? aggSource->messagesHandled() : 0);
+    long requests = aggSource ? aggSource->requestsServed() : 0;
+    double ticks = now > epochStart ? now - epochStart : 1;
+    aggEpoch = epoch;
+    aggWeight = 1;
+    aggSum[AGG_LOAD] = (messages - epochMessages) / ticks;
+    aggSum[AGG_KEYS] = aggSource ? aggSource->keysStored() : 0;
+    aggSum[AGG_REQUESTS] = (requests - epochRequests) / ticks;
+    epochMessages = messages;
+    epochRequests = requests;
+    epochStart = now;
+}
+
+/**
+ * FUNCTION NAME: mergeAggregateShare
+ *
+ * DESCRIPTION: Add the push-sum share carried by the message. Shares of an epoch that already
+ * 				ended are dropped, a share of a later epoch moves us to that epoch first.
+ */
+void MP1Node::mergeAggregateShare(MessageHdr* msg) {
+    if(msg->aggWeight <= 0)
+        return;
+    if(msg->aggEpoch > aggEpoch)
+        startAggregateEpoch(msg->aggEpoch);
+    if(msg->aggEpoch != aggEpoch)
+        return;
+    aggWeight += msg->aggWeight;
+    for(int m = 0; m < AGGREGATES; ++m)
+        aggSum[m] += msg->aggSum[m];
+}
+
+/**
+ * FUNCTION NAME: broadcast
+ *
+ * DESCRIPTION: Send the payload to every node of the group over the Plumtree broadcast tree.
+ * 				Returns false if the node is not in the group or the payload does not fit in a message.
+ */
+bool MP1Node::broadcast(const string &payload) {
+    if(!memberNode->inGroup || (int)payload.size() > maxBroadcastPayload())
+        return false;
+
+    int id = 0;
+    short port;
+    memcpy(&id, &memberNode->addr.addr[0], sizeof(int));
+    memcpy(&port, &memberNode->addr.addr[4], sizeof(short));
+    // The origin's key in the high bits, so receivers know who sent it
+    unsigned long long broadcastId = (memberKey(id, port) << 16) | (++broadcastSeq & 0xffff);
+    deliverBroadcast(broadcastId, 0, payload.data(), payload.size(), 0);
+    return true;
+}
+
+/**
+ * FUNCTION NAME: sendBroadcastMessage
+ *
+ * DESCRIPTION: sends a message of the broadcast tree using EmulNet
+ */
+void MP1Node::sendBroadcastMessage(Address* toAddress, MsgTypes msgType, unsigned long long id, int round, const char *data, int size) {
+    size_t total = sizeof(MessageHdr) + sizeof(BroadcastHdr) + size;
+    if(sendBuffer.size() < total)
+        sendBuffer.resize(total);
+
+    MessageHdr* msg = (MessageHdr*) &sendBuffer[0];
+    writeHeader(msg, msgType, 0, false);
+    BroadcastHdr* hdr = (BroadcastHdr*) (msg + 1);
+    hdr->id = id;
+    hdr->round = round;
+    hdr->size = size;
+    if(size > 0)
+        memcpy(hdr + 1, data, size);
+    emulNet->ENsend(&memberNode->addr, toAddress, &sendBuffer[0], total);
+}
+
+/**
+ * FUNCTION NAME: broadcastHandler
+ *
+ * DESCRIPTION: The function processing the BCAST, IHAVE, GRAFT and PRUNE messages of the broadcast tree.
+ * 				A new broadcast grafts the link it came over, a duplicate prunes it on both sides.
+ * 				An announced broadcast is waited for TGRAFT ticks before the announcer is asked for it.
+ */
+void MP1Node::broadcastHandler(MessageHdr* msg, int size) {
+    BroadcastHdr* hdr = (BroadcastHdr*) (msg + 1);
+    int header = sizeof(MessageHdr) + sizeof(BroadcastHdr);
+    if(size < header || hdr->size < 0 || size < header + hdr->size)
+        return;
+    heardFrom(msg);
+
+    int srcid = 0;
+    short srcport;
+    memcpy(&srcid, &msg->addr[0], sizeof(int));
+    memcpy(&srcport, &msg->addr[4], sizeof(short));
+    unsigned long long from = memberKey(srcid, srcport);
+    Address source = senderAddress(msg);
+    const char *data = (const char *) (hdr + 1);
+
+    if(msg->msgType == BCAST) {
+        if(plumtree.lookup(hdr->id) == NULL) {
+            plumtree.graft(from);
+            deliverBroadcast(hdr->id, hdr->round + 1, data, hdr->size, from);
+        } else {
+            plumtree.prune(from);
+            sendBroadcastMessage(&source, PRUNE, hdr->id, 0, NULL, 0);
+        }
+    } else if(msg->msgType == IHAVE) {
+        const unsigned long long *ids = (const unsigned long long *) data;
+        int count = hdr->size / sizeof(unsigned long long);
+        for(int i = 0; i < count; ++i)
+            plumtree.announced(ids[i], from, this->par->getcurrtime() + TGRAFT);
+    } else if(msg->msgType == GRAFT) {
+        plumtree.graft(from);
+        const BroadcastMessage *message = plumtree.lookup(hdr->id);
+        if(message != NULL)
+            sendBroadcastMessage(&source, BCAST, hdr->id, message->round, message->payload.data(), message->payload.size());
+    } else if(msg->msgType == PRUNE) {
+        plumtree.prune(from);
+    }
+}
+
+/**
+ * FUNCTION NAME: deliverBroadcast
+ *
+ * DESCRIPTION: Hand a new broadcast to the listeners and push it to the eager peers but the one it came from.
+ * 				Its id is announced to the lazy peers at the end of the tick.
+ */
+void MP1Node::deliverBroadcast(unsigned long long id, int round, const char *payload, int size, unsigned long long from) {
+    plumtree.store(id, round, payload, size, this->par->getcurrtime() + TBROADCAST);
+
+    const vector<unsigned long long>& eager = plumtree.eagerPeers();
+    for(size_t i = 0; i < eager.size(); ++i) {
+        if(eager[i] == from)
+            continue;
+        Address address = keyAddress(eager[i]);
+        sendBroadcastMessage(&address, BCAST, id, round, payload, size);
+    }
+
+    Address origin = keyAddress(id >> 16);
+#ifdef DEBUGLOG
+    log->LOG(&memberNode->addr, "Broadcast %llx from %s delivered after %d hops", id, origin.getAddress().c_str(), round);
+#endif
+    // Listeners get the stored copy, so delivering does not allocate
+    const string &message = plumtree.lookup(id)->payload;
+    for(size_t i = 0; i < broadcastListeners.size(); ++i)
+        broadcastListeners[i]->broadcastDelivered(&origin, message);
+}
+
+/**
+ * FUNCTION NAME: broadcastTick
+ *
+ * DESCRIPTION: Once a tick: graft the links of the broadcasts that were announced but did not arrive,
+ * 				announce the broadcasts received in this tick to the lazy peers, and forget the old ones.
+ */
+void MP1Node::broadcastTick() {
+    long now = this->par->getcurrtime();
+    plumtree.expire(now);
+
+    grafts.clear();
+    plumtree.timedOut(now, TGRAFT, grafts);
+    for(size_t i = 0; i < grafts.size(); ++i) {
+        plumtree.graft(grafts[i].second);
+        Address address = keyAddress(grafts[i].second);
+        sendBroadcastMessage(&address, GRAFT, grafts[i].first, 0, NULL, 0);
+    }
+
+    vector<unsigned long long>& pending = plumtree.pendingAnnouncements();
+    if(pending.empty())
+        return;
+    int perMessage = maxBroadcastPayload() / (int)sizeof(unsigned long long);
+    const vector<unsigned long long>& lazy = plumtree.lazyPeers();
+    for(size_t i = 0; i < lazy.size(); ++i) {
+        Address address = keyAddress(lazy[i]);
+        for(size_t first = 0; first < pending.size(); first += perMessage) {
+            int count = min((int)(pending.size() - first), perMessage);
+            sendBroadcastMessage(&address, IHAVE, 0, 0, (const char *) &pending[first], count * sizeof(unsigned long long));
+        }
+    }
+    pending.clear();
+}
+
+/**
+ * FUNCTION NAME: refillBroadcastView
+ *
+ * DESCRIPTION: Replace a peer of the broadcast view that left the group with a random member
+ */
+void MP1Node::refillBroadcastView() {
+    int num_members = memberNode->memberList.size();
+    for(int attempt = 0; attempt < PLUMTREE_VIEW && (int)plumtree.viewSize() < min(num_members, PLUMTREE_VIEW); ++attempt) {
+        int i = rand() % num_members;
+        unsigned long long key = memberKey(memberNode->memberList.id(i), memberNode->memberList.port(i));
+        if(!plumtree.inView(key))
+            plumtree.graft(key);
+    }
 }
 
 /**
  * FUNCTION NAME: pingHandler
  *
- * DESCRIPTION: The function processing the PING messages.
+ * DESCRIPTION: The function processing the PING messages. Pings carry only a digest of the
+ * 				sender's membership, the entries are sent back in a SYNC when it differs from ours.
  */
 void MP1Node::pingHandler(MessageHdr* msg) {
-    //Update source member
+    heardFrom(msg);
+    if(msg->digest != membershipDigest()) {
+        Address source = senderAddress(msg);
+        sendMessage(&source, SYNC);
+    }
+}
+
+/**
+ * FUNCTION NAME: syncHandler
+ *
+ * DESCRIPTION: The function processing the SYNC and SYNCREP messages. A SYNC is answered with
+ * 				our own entries if the digests still differ after merging, a SYNCREP is not answered.
+ * 				A SYNC from another zone is a cross-zone exchange of the hierarchical mode and is always
+ * 				answered with the entries of our zone.
+ */
+void MP1Node::syncHandler(MessageHdr* msg) {
+    heardFrom(msg);
+    mergeMemberList(msg);
+    int srcid = 0;
+    memcpy(&srcid, &msg->addr[0], sizeof(int));
+    int self = 0;
+    memcpy(&self, &memberNode->addr.addr[0], sizeof(int));
+    bool crossZone = this->par->HIERARCHICAL && this->par->zoneOf(srcid) != this->par->zoneOf(self);
+    if(msg->msgType == SYNC && crossZone) {
+        // Only our zone's entries, the sender knows the rest at least as well
+        Address source = senderAddress(msg);
+        sendMessage(&source, SYNCREP, zoneEntries(this->par->zoneOf(self), true));
+    } else if(msg->msgType == SYNC && msg->digest != membershipDigest()) {
+        Address source = senderAddress(msg);
+        sendMessage(&source, SYNCREP);
+    }
+}
+
+/**
+ * FUNCTION NAME: heardFrom
+ *
+ * DESCRIPTION: Update the sender of a message in the memberList, adding it if it is unknown
+ */
+void MP1Node::heardFrom(MessageHdr* msg) {
     int srcid = 0;
     short srcport;
-    memcpy(&srcid, &msg->addr->addr[0], sizeof(int));
-    memcpy(&srcport, &msg->addr->addr[4], sizeof(short));
-    MemberListEntry* sourceMember = checkMemberList(srcid, srcport);
-    if(sourceMember != nullptr) {
-        ++(sourceMember->heartbeat);
-        sourceMember->timestamp = this->par->getcurrtime();
+    memcpy(&srcid, &msg->addr[0], sizeof(int));
+    memcpy(&srcport, &msg->addr[4], sizeof(short));
+    int source = checkMemberList(srcid, srcport);
+    if(source >= 0) {
+        // A direct message is first-hand evidence that the source is alive
+        if(isNewer(msg->incarnation, msg->heartbeat, source)) {
+            setIncarnation(source, msg->incarnation);
+            memberNode->memberList.heartbeat(source) = msg->heartbeat;
+        }
+        memberNode->memberList.timestamp(source) = this->par->getcurrtime();
+        refreshMember(source, this->par->getcurrtime());
     } else {
         AddToMemberList(msg);
     }
+}
 
-    int num_members = msg->memberList.size();
+/**
+ * FUNCTION NAME: mergeMemberList
+ *
+ * DESCRIPTION: Merge the entries carried by the message into the memberList
+ */
+void MP1Node::mergeMemberList(MessageHdr* msg) {
+    MessageEntry* messageEntries = (MessageEntry*) (msg + 1);
+    int num_members = msg->numEntries;
     for(int i=0; i<num_members; ++i) {
-        int id = msg->memberList[i].id;
-        short port = msg->memberList[i].port;
-        long heartbeat = msg->memberList[i].heartbeat;
+        int id = messageEntries[i].id;
+        short port = messageEntries[i].port;
+        long heartbeat = messageEntries[i].heartbeat;
+        long incarnation = messageEntries[i].incarnation;
 
-        MemberListEntry* memberListEntry = checkMemberList(id, port);
-        if(memberListEntry == nullptr){
-            AddToMemberList(&msg->memberList[i]);
+        int index = checkMemberList(id, port);
+        if(index < 0){
+            MemberListEntry gossiped = unpackEntry(&messageEntries[i]);
+            AddToMemberList(&gossiped);
         } else {
-            if(heartbeat > memberListEntry->heartbeat) {
-                memberListEntry->heartbeat = heartbeat;
-                memberListEntry->timestamp = this->par->getcurrtime();
+            if(isNewer(incarnation, heartbeat, index)) {
+                setIncarnation(index, incarnation);
+                memberNode->memberList.heartbeat(index) = heartbeat;
+                memberNode->memberList.timestamp(index) = this->par->getcurrtime();
+                refreshMember(index, this->par->getcurrtime());
             }
         }
     }
 }
 
+/**
+ * FUNCTION NAME: leaveHandler
+ *
+ * DESCRIPTION: The function processing the LEAVE messages. Members that announced their departure
+ * 				are removed right away and the announcement is passed on in the next gossip round.
+ * 				A LEAVE about this node means it was removed while alive: it refutes the removal
+ * 				by moving to a newer incarnation, which overrides the tombstones of the older one.
+ */
+void MP1Node::leaveHandler(MessageHdr* msg) {
+    MessageEntry* messageEntries = (MessageEntry*) (msg + 1);
+    int num_leaving = msg->numEntries;
+    for(int i=0; i<num_leaving; ++i) {
+        MemberListEntry leaving = unpackEntry(&messageEntries[i]);
+        unsigned long long key = memberKey(leaving.id, leaving.port);
+        Address addr = getAddress(leaving.id, leaving.port);
+        if(addr == memberNode->addr) {
+            if(memberNode->inGroup && leaving.incarnation >= memberNode->incarnation) {
+                memberNode->incarnation = leaving.incarnation + 1;
+#ifdef DEBUGLOG
+                log->LOG(&memberNode->addr, "Refuted removal, now incarnation %ld", memberNode->incarnation);
+#endif
+            }
+            continue;
+        }
+
+        // Already known, this copy of the announcement goes no further
+        if(tombstones.buries(key, leaving.incarnation))
+            continue;
+
+        unordered_map<unsigned long long, int>::iterator it = memberIndex.find(key);
+        if(it != memberIndex.end()) {
+            if(memberNode->memberList.incarnation(it->second) > leaving.incarnation)
+                continue;
+            removeMember(it->second);
+        }
+        tombstones.add(key, leaving.incarnation, this->par->getcurrtime() + TTOMBSTONE);
+        pendingLeaves.push_back(leaving);
+    }
+}
+
+/**
+ * FUNCTION NAME: notifyRemoved
+ *
+ * DESCRIPTION: Send a LEAVE about a removed member to the member itself.
+ * 				If it is still alive it refutes the removal with a new incarnation.
+ */
+void MP1Node::notifyRemoved(int id, short port, long heartbeat, long incarnation) {
+    MemberListEntry removed(id, port, heartbeat, this->par->getcurrtime());
+    removed.incarnation = incarnation;
+    // The gossip window is free between two messages
+    window.clear();
+    window.push_back(removed);
+    Address address = getAddress(id, port);
+    sendMessage(&address, LEAVE, window);
+}
+
 /**
  * FUNCTION NAME: getAddress
  *
  * DESCRIPTION: return address given the id and port
  */
-Address* MP1Node::getAddress(int id, short port) {
-    Address* address = new Address();
-    memcpy(&address->addr[0], &id, sizeof(int));
-    memcpy(&address->addr[4], &port, sizeof(short));
+Address MP1Node::getAddress(int id, short port) {
+    Address address;
+    memcpy(&address.addr[0], &id, sizeof(int));
+    memcpy(&address.addr[4], &port, sizeof(short));
+    return address;
+}
+
+/**
+ * FUNCTION NAME: keyAddress
+ *
+ * DESCRIPTION: return the address of the member with the given memberKey
+ */
+Address MP1Node::keyAddress(unsigned long long key) {
+    return getAddress((int)(key >> 16), (short)(key & 0xffff));
+}
+
+/**
+ * FUNCTION NAME: senderAddress
+ *
+ * DESCRIPTION: return the address of the node that sent the message
+ */
+Address MP1Node::senderAddress(MessageHdr* msg) {
+    Address address;
+    memcpy(address.addr, msg->addr, sizeof(address.addr));
     return address;
 }
 
+/**
+ * FUNCTION NAME: unpackEntry
+ *
+ * DESCRIPTION: return the memberList entry carried by a message
+ */
+MemberListEntry MP1Node::unpackEntry(MessageEntry* messageEntry) {
+    MemberListEntry memberListEntry(messageEntry->id, messageEntry->port, messageEntry->heartbeat, messageEntry->timestamp);
+    memberListEntry.incarnation = messageEntry->incarnation;
+    return memberListEntry;
+}
+
+/**
+ * FUNCTION NAME: hasFailed
+ *
+ * DESCRIPTION: Decide whether a member should be removed from the memberList.
+ * 				With a PHI_THRESHOLD the phi-accrual detector decides, otherwise a member
+ * 				is removed once it has not refreshed its heartbeat for TREMOVE ticks.
+ */
+bool MP1Node::hasFailed(int index) {
+    if(this->par->PHI_THRESHOLD > 0) {
+        unsigned long long key = memberKey(memberNode->memberList.id(index), memberNode->memberList.port(index));
+        return detector.phi(key, this->par->getcurrtime()) >= this->par->PHI_THRESHOLD;
+    }
+    return this->par->getcurrtime() - memberNode->memberList.timestamp(index) >= TREMOVE;
+}
+
+/**
+ * FUNCTION NAME: isNewer
+ *
+ * DESCRIPTION: Returns true if (incarnation, heartbeat) is more recent than what the entry at index holds.
+ * 				A restarted node counts its heartbeat from zero again, so incarnations are compared first.
+ */
+bool MP1Node::isNewer(long incarnation, long heartbeat, int index) {
+    if(incarnation != memberNode->memberList.incarnation(index))
+        return incarnation > memberNode->memberList.incarnation(index);
+    return heartbeat > memberNode->memberList.heartbeat(index);
+}
+
+/**
+ * FUNCTION NAME: expiryTime
+ *
+ * DESCRIPTION: Time at which the member is due to be checked by hasFailed again
+ */
+long MP1Node::expiryTime(int index) {
+    long now = this->par->getcurrtime();
+    long deadline = memberNode->memberList.timestamp(index) + TREMOVE;
+    if(this->par->PHI_THRESHOLD > 0) {
+        unsigned long long key = memberKey(memberNode->memberList.id(index), memberNode->memberList.port(index));
+        deadline = detector.deadline(key, this->par->PHI_THRESHOLD);
+    }
+    return deadline > now ? deadline : now + 1;
+}
+
+/**
+ * FUNCTION NAME: refreshMember
+ *
+ * DESCRIPTION: Record a heartbeat arrival of the member and reschedule its expiry timer
+ */
+void MP1Node::refreshMember(int index, long arrival) {
+    unsigned long long key = memberKey(memberNode->memberList.id(index), memberNode->memberList.port(index));
+    detector.heartbeat(key, arrival);
+    expiry.schedule(key, expiryTime(index));
+}
+
+/**
+ * FUNCTION NAME: removeMember
+ *
+ * DESCRIPTION: Remove the member at index from the memberList. The last member takes its place.
+ */
+void MP1Node::removeMember(int index) {
+    MemberListEntry removed = memberNode->memberList.at(index);
+    unsigned long long key = memberKey(removed.id, removed.port);
+    Address addressToRemove = getAddress(removed.id, removed.port);
+    log->logNodeRemove(&memberNode->addr, &addressToRemove);
+
+    int last = memberNode->memberList.size() - 1;
+    memberIndex[memberKey(memberNode->memberList.id(last), memberNode->memberList.port(last))] = index;
+    memberNode->memberList.removeAt(index);
+    memberIndex.erase(key);
+    membersDigest ^= entryDigest(removed.id, removed.port, removed.incarnation);
+    detector.remove(key);
+    expiry.cancel(key);
+    tombstones.add(key, removed.incarnation, this->par->getcurrtime() + TTOMBSTONE);
+    notifyLeft(removed.id, removed.port);
+}
+
+/**
+ * FUNCTION NAME: addListener
+ *
+ * DESCRIPTION: Subscribe the listener to the membership change events of this node
+ */
+void MP1Node::addListener(MembershipListener *listener) {
+    listeners.push_back(listener);
+}
+
+/**
+ * FUNCTION NAME: addBroadcastListener
+ *
+ * DESCRIPTION: Subscribe the listener to the broadcasts delivered at this node
+ */
+void MP1Node::addBroadcastListener(BroadcastListener *listener) {
+    broadcastListeners.push_back(listener);
+}
 
+/**
+ * FUNCTION NAME: setAggregateSource
+ *
+ * DESCRIPTION: Set the layer whose counters are aggregated together with the membership protocol's
+ */
+void MP1Node::setAggregateSource(AggregateSource *source) {
+    aggSource = source;
+}
 
+/**
+ * FUNCTION NAME: getAggregateAverage
+ *
+ * DESCRIPTION: Returns the push-sum estimate of the per node average of the metric, as of the last complete epoch
+ */
+double MP1Node::getAggregateAverage(int metric) {
+    return aggAverage[metric];
+}
+
+/**
+ * FUNCTION NAME: getAggregateTotal
+ *
+ * DESCRIPTION: Returns the estimate of the metric summed over the cluster, the average times the group size we know of
+ */
+double MP1Node::getAggregateTotal(int metric) {
+    return aggAverage[metric] * (memberNode->memberList.size() + 1);
+}
+
+/**
+ * FUNCTION NAME: notifyJoined
+ *
+ * DESCRIPTION: Bump the membership version and tell the listeners that a member was added.
+ * 				The member is also offered to the broadcast view.
+ */
+void MP1Node::notifyJoined(int id, short port) {
+    ++membershipVersion;
+    plumtree.addPeer(memberKey(id, port));
+    Address address = getAddress(id, port);
+    for(size_t i = 0; i < listeners.size(); ++i)
+        listeners[i]->memberJoined(&address, membershipVersion);
+}
+
+/**
+ * FUNCTION NAME: notifyLeft
+ *
+ * DESCRIPTION: Bump the membership version and tell the listeners that a member was removed.
+ * 				A broadcast view peer that left is replaced.
+ */
+void MP1Node::notifyLeft(int id, short port) {
+    ++membershipVersion;
+    if(plumtree.removePeer(memberKey(id, port)))
+        refillBroadcastView();
+    Address address = getAddress(id, port);
+    for(size_t i = 0; i < listeners.size(); ++i)
+        listeners[i]->memberLeft(&address, membershipVersion);
+}
+
+/**
+ * FUNCTION NAME: setIncarnation
+ *
+ * DESCRIPTION: Change the incarnation of a member, keeping the membership digest up to date
+ */
+void MP1Node::setIncarnation(int index, long incarnation) {
+    int id = memberNode->memberList.id(index);
+    short port = memberNode->memberList.port(index);
+    membersDigest ^= entryDigest(id, port, memberNode->memberList.incarnation(index));
+    memberNode->memberList.incarnation(index) = incarnation;
+    membersDigest ^= entryDigest(id, port, incarnation);
+    noteChange(id, port);
+}
+
+/**
+ * FUNCTION NAME: entryDigest
+ *
+ * DESCRIPTION: 64-bit hash of a member and its incarnation (splitmix64 finalizer).
+ * 				Heartbeats are left out, they change every round and liveness comes from direct pings.
+ */
+unsigned long long MP1Node::entryDigest(int id, short port, long incarnation) {
+    unsigned long long h = memberKey(id, port) ^ ((unsigned long long)incarnation * 0x9E3779B97F4A7C15ULL);
+    h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    h = (h ^ (h >> 27)) * 0x94D049BB133111EBULL;
+    return h ^ (h >> 31);
+}
+
+/**
+ * FUNCTION NAME: membershipDigest
+ *
+ * DESCRIPTION: Order independent digest of the membership as seen by this node, itself included.
+ * 				Two nodes that agree on the members and their incarnations have equal digests.
+ */
+unsigned long long MP1Node::membershipDigest() {
+    int id = 0;
+    short port;
+    memcpy(&id, &memberNode->addr.addr[0], sizeof(int));
+    memcpy(&port, &memberNode->addr.addr[4], sizeof(short));
+    return membersDigest ^ entryDigest(id, port, memberNode->incarnation);
+}
@@ -14,12 +14,30 @@
 #include "Member.h"
 #include "EmulNet.h"
 #include "Queue.h"
+#include "FailureDetector.h"
+#include "TimerWheel.h"
+#include "TombstoneSet.h"
+#include "MembershipListener.h"
+#include "MembershipSnapshot.h"
+#include "AggregateSource.h"
+#include "Plumtree.h"
+#include "BroadcastListener.h"
 
 /**
  * Macros
  */
 #define TREMOVE 20
 #define TFAIL 5
+#define TJOIN 5
+#define TTOMBSTONE (3 * TREMOVE)
+#define TOMBSTONE_LIMIT 1024
+#define RECENT_CHANGES 16
+#define ZONE_GATEWAYS 2
+#define TAGGREGATE 20
+#define PLUMTREE_VIEW 6
+#define TGRAFT 3
+#define TBROADCAST (3 * TREMOVE)
+#define PLUMTREE_MESSAGES 16
 
 /*
  * Note: You can change/add any functions in MP1Node.{h,cpp}
@@ -32,20 +50,59 @@ enum MsgTypes{
     JOINREQ,
     JOINREP,
     DUMMYLASTMSGTYPE,
-    PING
+    PING,
+    LEAVE,
+    SYNC,
+    SYNCREP,
+    BCAST,
+    IHAVE,
+    GRAFT,
+    PRUNE
 };
 
 /**
  * STRUCT NAME: MessageHdr
  *
- * DESCRIPTION: Header and content of a message
+ * DESCRIPTION: Header of a message, followed on the wire by numEntries MessageEntry
  */
 typedef struct MessageHdr {
 	enum MsgTypes msgType;
-	std::vector<MemberListEntry> memberList;
-	Address* addr;
+	char addr[6];
+	long heartbeat;
+	long incarnation;
+	unsigned long long digest;
+	int numEntries;
+	// Push-sum share of the aggregation epoch, a zero weight when the message carries none
+	long aggEpoch;
+	double aggWeight;
+	double aggSum[AGGREGATES];
 }MessageHdr;
 
+/**
+ * STRUCT NAME: MessageEntry
+ *
+ * DESCRIPTION: Member entry carried by a message
+ */
+typedef struct MessageEntry {
+	int id;
+	short port;
+	long heartbeat;
+	long incarnation;
+	long timestamp;
+}MessageEntry;
+
+/**
+ * STRUCT NAME: BroadcastHdr
+ *
+ * DESCRIPTION: Follows the MessageHdr of the broadcast messages, and is followed by size bytes:
+ * 				the payload of a BCAST, the broadcast ids of an IHAVE. A GRAFT asks for broadcast id.
+ */
+typedef struct BroadcastHdr {
+	unsigned long long id;
+	int round;
+	int size;
+}BroadcastHdr;
+
 /**
  * CLASS NAME: MP1Node
  *
@@ -58,12 +115,71 @@ private:
 	Params *par;
 	Member *memberNode;
 	char NULLADDR[6];
+	PhiAccrualDetector detector;
+	// Expiry timer of every member in the memberList
+	TimerWheel expiry;
+	// Position of every member in the memberList
+	unordered_map<unsigned long long, int> memberIndex;
+	// Scratch buffer for the members whose expiry timer fired
+	vector<unsigned long long> expired;
+	// Recently removed members, so stale gossip cannot add them back
+	TombstoneSet tombstones;
+	// Departures learnt since the last gossip round, to be passed on
+	vector<MemberListEntry> pendingLeaves;
+	// XOR of the entryDigest of every member in the memberList
+	unsigned long long membersDigest;
+	// Bumped on every change to the memberList
+	long membershipVersion;
+	vector<MembershipListener *> listeners;
+	// Join requests sent so far, and the time to try the next introducer (-1 when not joining)
+	int joinAttempts;
+	long joinDeadline;
+	// Outgoing messages are serialized here, sized for the whole group up front
+	vector<char> sendBuffer;
+	// Entries gossiped when the memberList does not fit in one message
+	vector<MemberListEntry> window;
+	// memberList position the round robin part of the next window starts at
+	int windowCursor;
+	// Ring of recently changed members and the time of the change, newest before recentHead
+	vector<pair<unsigned long long, long> > recentChanges;
+	int recentHead;
+	// Written every SNAPSHOT_INTERVAL ticks, read back when the node restarts
+	MembershipSnapshot snapshot;
+	// memberList positions of the members the zone leader exchanges with, ZONE_GATEWAYS slots per zone
+	vector<int> zoneGateways;
+	// Push-sum state of the current aggregation epoch, and the averages of the last complete one
+	long aggEpoch;
+	double aggWeight;
+	double aggSum[AGGREGATES];
+	double aggAverage[AGGREGATES];
+	AggregateSource *aggSource;
+	// Messages handled by this layer, and the counters and time at the start of the epoch to take rates over
+	long messagesHandled;
+	long epochMessages;
+	long epochRequests;
+	long epochStart;
+	// Epidemic broadcast tree over a sample of the members
+	Plumtree plumtree;
+	vector<BroadcastListener *> broadcastListeners;
+	// Broadcasts sent by this node, numbers its broadcast ids
+	long broadcastSeq;
+	// Scratch buffer for the grafts due this tick
+	vector<pair<unsigned long long, unsigned long long> > grafts;
 
 public:
 	MP1Node(Member *, Params *, EmulNet *, Log *, Address *);
 	Member * getMemberNode() {
 		return memberNode;
 	}
+	long getMembershipVersion() {
+		return membershipVersion;
+	}
+	void addListener(MembershipListener *listener);
+	void setAggregateSource(AggregateSource *source);
+	double getAggregateAverage(int metric);
+	double getAggregateTotal(int metric);
+	void addBroadcastListener(BroadcastListener *listener);
+	bool broadcast(const string &payload);
 	int recvLoop();
 	static int enqueueWrapper(void *env, char *buff, int size);
 	void nodeStart(char *servaddrstr, short serverport);
@@ -77,13 +193,48 @@ public:
 	int isNullAddress(Address *addr);
 	Address getJoinAddress();
 	void initMemberListTable(Member *memberNode);
+	void restoreSnapshot();
 	void printAddress(Address *addr);
 	void AddToMemberList(MessageHdr* msg);
 	void AddToMemberList(MemberListEntry* memberListEntry);
-	MemberListEntry* checkMemberList(int id, short port);
+	int checkMemberList(int id, short port);
 	void sendMessage(Address* toAddress, MsgTypes msgType);
+	void sendMessage(Address* toAddress, MsgTypes msgType, const vector<MemberListEntry>& entries, bool pushShare = false);
+	void sendJoinReply(Address* toAddress);
+	void writeHeader(MessageHdr* msg, MsgTypes msgType, int numEntries, bool pushShare);
+	int maxGossipEntries();
+	int maxBroadcastPayload();
+	const vector<MemberListEntry>& gossipEntries();
+	void noteChange(int id, short port);
+	void zoneGossip(const vector<MemberListEntry>& noEntries);
+	void startAggregateEpoch(long epoch);
+	void mergeAggregateShare(MessageHdr* msg);
+	void sendBroadcastMessage(Address* toAddress, MsgTypes msgType, unsigned long long id, int round, const char *data, int size);
+	void broadcastHandler(MessageHdr* msg, int size);
+	void deliverBroadcast(unsigned long long id, int round, const char *payload, int size, unsigned long long from);
+	void broadcastTick();
+	void refillBroadcastView();
+	const vector<MemberListEntry>& zoneEntries(int zone, bool inside);
 	void pingHandler(MessageHdr* msg);
-	Address* getAddress(int id, short port);
+	void syncHandler(MessageHdr* msg);
+	void heardFrom(MessageHdr* msg);
+	void mergeMemberList(MessageHdr* msg);
+	void leaveHandler(MessageHdr* msg);
+	void notifyRemoved(int id, short port, long heartbeat, long incarnation);
+	bool hasFailed(int index);
+	bool isNewer(long incarnation, long heartbeat, int index);
+	long expiryTime(int index);
+	void refreshMember(int index, long arrival);
+	void removeMember(int index);
+	void notifyJoined(int id, short port);
+	void notifyLeft(int id, short port);
+	void setIncarnation(int index, long incarnation);
+	unsigned long long entryDigest(int id, short port, long incarnation);
+	unsigned long long membershipDigest();
+	Address getAddress(int id, short port);
+	Address keyAddress(unsigned long long key);
+	Address senderAddress(MessageHdr* msg);
+	MemberListEntry unpackEntry(MessageEntry* messageEntry);
 	virtual ~MP1Node();
 };
 
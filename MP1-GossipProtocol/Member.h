@@ -54,6 +54,15 @@ public:
 	}
 };
 
+/**
+ * FUNCTION NAME: memberKey
+ *
+ * DESCRIPTION: Packs the id and port of a member into a single lookup key
+ */
+inline unsigned long long memberKey(int id, short port) {
+	return ((unsigned long long)(unsigned int)id << 16) | (unsigned short)port;
+}
+
 /**
  * CLASS NAME: MemberListEntry
  *
@@ -65,19 +74,66 @@ public:
 	short port;
 	long heartbeat;
 	long timestamp;
+	long incarnation;
 	MemberListEntry(int id, short port, long heartbeat, long timestamp);
 	MemberListEntry(int id, short port);
-	MemberListEntry(): id(0), port(0), heartbeat(0), timestamp(0) {}
+	MemberListEntry(): id(0), port(0), heartbeat(0), timestamp(0), incarnation(0) {}
 	MemberListEntry(const MemberListEntry &anotherMLE);
 	MemberListEntry& operator =(const MemberListEntry &anotherMLE);
 	int getid();
 	short getport();
 	long getheartbeat();
 	long gettimestamp();
+	long getincarnation();
 	void setid(int id);
 	void setport(short port);
 	void setheartbeat(long hearbeat);
 	void settimestamp(long timestamp);
+	void setincarnation(long incarnation);
+};
+
+/**
+ * CLASS NAME: MembershipTable
+ *
+ * DESCRIPTION: Membership table stored as a struct of arrays. Each field of the entries is
+ * 				its own contiguous column, so that scans over timestamps or heartbeats only
+ * 				touch the column they need and can compare several entries per instruction.
+ * 				Removing an entry moves the last entry into its place.
+ */
+class MembershipTable {
+private:
+	vector<int> ids;
+	vector<short> ports;
+	vector<long> heartbeats;
+	vector<long> timestamps;
+	vector<long> incarnations;
+public:
+	size_t size() const {
+		return ids.size();
+	}
+	bool empty() const {
+		return ids.empty();
+	}
+	int &id(size_t index) {
+		return ids[index];
+	}
+	short &port(size_t index) {
+		return ports[index];
+	}
+	long &heartbeat(size_t index) {
+		return heartbeats[index];
+	}
+	long &timestamp(size_t index) {
+		return timestamps[index];
+	}
+	long &incarnation(size_t index) {
+		return incarnations[index];
+	}
+	MemberListEntry at(size_t index) const;
+	void push_back(const MemberListEntry &entry);
+	void removeAt(size_t index);
+	void reserve(size_t capacity);
+	void clear();
 };
 
 /**
@@ -100,12 +156,14 @@ public:
 	int nnb;
 	// the node's own heartbeat
 	long heartbeat;
+	// number of times this node has (re)started, orders its heartbeats across restarts
+	long incarnation;
 	// counter for next ping
 	int pingCounter;
 	// counter for ping timeout
 	int timeOutCounter;
 	// Membership table
-	vector<MemberListEntry> memberList;
+	MembershipTable memberList;
 	// My position in the membership table
 	vector<MemberListEntry>::iterator myPos;
 	// Queue for failure detection messages
@@ -113,7 +171,7 @@ public:
 	/**
 	 * Constructor
 	 */
-	Member(): inited(false), inGroup(false), bFailed(false), nnb(0), heartbeat(0), pingCounter(0), timeOutCounter(0) {}
+	Member(): inited(false), inGroup(false), bFailed(false), nnb(0), heartbeat(0), incarnation(0), pingCounter(0), timeOutCounter(0) {}
 	// copy constructor
 	Member(const Member &anotherMember);
 	// Assignment operator overloading
@@ -0,0 +1,162 @@
+/**********************************
+ * FILE NAME: MembershipBench.cpp
+ *
+ * DESCRIPTION: Benchmark of the expiry scan over the membership table.
+ * 				Compares a vector of MemberListEntry (array of structs) with the
+ * 				MembershipTable columns (struct of arrays), scalar and AVX2.
+ * 				Build and run with "make bench".
+ **********************************/
+
+#include "Member.h"
+#include <chrono>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+#define BENCH_ROUNDS 200
+// One member in STALE_EVERY is older than the cutoff
+#define STALE_EVERY 100
+
+/**
+ * FUNCTION NAME: olderThanAoS
+ *
+ * DESCRIPTION: the expiry scan as it looks over a vector of MemberListEntry
+ */
+static void olderThanAoS(const vector<MemberListEntry> &memberList, long cutoff, vector<int> &indices) {
+	size_t n = memberList.size();
+	for( size_t i = 0; i < n; i++ ) {
+		if( memberList[i].timestamp < cutoff ) {
+			indices.push_back(i);
+		}
+	}
+}
+
+/**
+ * FUNCTION NAME: olderThanScalar
+ *
+ * DESCRIPTION: the expiry scan over the timestamp column of a MembershipTable
+ */
+static void olderThanScalar(MembershipTable &table, long cutoff, vector<int> &indices) {
+	size_t n = table.size();
+	for( size_t i = 0; i < n; i++ ) {
+		if( table.timestamp(i) < cutoff ) {
+			indices.push_back(i);
+		}
+	}
+}
+
+#if defined(__x86_64__)
+/**
+ * FUNCTION NAME: olderThanAVX2
+ *
+ * DESCRIPTION: olderThanScalar comparing four 64-bit timestamps per instruction.
+ * 				Only called when hasAVX2 is true.
+ */
+__attribute__((target("avx2")))
+static void olderThanAVX2(MembershipTable &table, long cutoff, vector<int> &indices) {
+	size_t n = table.size();
+	size_t i = 0;
+	const long *column = n ? &table.timestamp(0) : NULL;
+	__m256i limit = _mm256_set1_epi64x(cutoff);
+	for( ; i + 4 <= n; i += 4 ) {
+		__m256i values = _mm256_loadu_si256((const __m256i *)(column + i));
+		int mask = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(limit, values)));
+		// Most members are fresh, so most blocks have nothing to report
+		while( mask ) {
+			int lane = __builtin_ctz(mask);
+			indices.push_back(i + lane);
+			mask &= mask - 1;
+		}
+	}
+	for( ; i < n; i++ ) {
+		if( column[i] < cutoff ) {
+			indices.push_back(i);
+		}
+	}
+}
+
+/**
+ * FUNCTION NAME: hasAVX2
+ *
+ * DESCRIPTION: true if the CPU running the benchmark supports AVX2
+ */
+static bool hasAVX2() {
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2");
+}
+#else
+static void olderThanAVX2(MembershipTable &table, long cutoff, vector<int> &indices) {
+	olderThanScalar(table, cutoff, indices);
+}
+
+static bool hasAVX2() {
+	return false;
+}
+#endif
+
+/**
+ * FUNCTION NAME: report
+ *
+ * DESCRIPTION: print the time per scan and per entry, and check the scan found every stale member
+ */
+static void report(const char *layout, size_t entries, double seconds, size_t found) {
+	double perScan = seconds / BENCH_ROUNDS;
+	printf("%-12s %7zu entries  %9.2f us/scan  %6.3f ns/entry  found %zu\n",
+		layout, entries, perScan * 1e6, perScan * 1e9 / entries, found);
+	assert(found == (entries + STALE_EVERY - 1) / STALE_EVERY);
+}
+
+/**
+ * FUNCTION NAME: bench
+ *
+ * DESCRIPTION: time BENCH_ROUNDS expiry scans of a table with the given number of entries
+ */
+static void bench(size_t entries) {
+	const long now = 1000;
+	const long cutoff = now - 20;
+	vector<MemberListEntry> aos;
+	MembershipTable soa;
+	for( size_t i = 0; i < entries; i++ ) {
+		long timestamp = (i % STALE_EVERY == 0) ? cutoff - 1 : now - (long)(i % 20);
+		MemberListEntry entry(i + 1, 0, i, timestamp);
+		aos.push_back(entry);
+		soa.push_back(entry);
+	}
+
+	vector<int> indices;
+	indices.reserve(entries);
+	chrono::steady_clock::time_point start;
+
+	start = chrono::steady_clock::now();
+	for( int r = 0; r < BENCH_ROUNDS; r++ ) {
+		indices.clear();
+		olderThanAoS(aos, cutoff, indices);
+	}
+	report("AoS", entries, chrono::duration<double>(chrono::steady_clock::now() - start).count(), indices.size());
+
+	start = chrono::steady_clock::now();
+	for( int r = 0; r < BENCH_ROUNDS; r++ ) {
+		indices.clear();
+		olderThanScalar(soa, cutoff, indices);
+	}
+	report("SoA scalar", entries, chrono::duration<double>(chrono::steady_clock::now() - start).count(), indices.size());
+
+	if( hasAVX2() ) {
+		start = chrono::steady_clock::now();
+		for( int r = 0; r < BENCH_ROUNDS; r++ ) {
+			indices.clear();
+			olderThanAVX2(soa, cutoff, indices);
+		}
+		report("SoA AVX2", entries, chrono::duration<double>(chrono::steady_clock::now() - start).count(), indices.size());
+	}
+	else {
+		printf("SoA AVX2     not supported by this CPU\n");
+	}
+}
+
+int main() {
+	bench(10000);
+	bench(100000);
+	return 0;
+}
@@ -0,0 +1,127 @@
+/**********************************
+ * FILE NAME: MembershipSnapshot.cpp
+ *
+ * DESCRIPTION: Definition of the MembershipSnapshot class
+ **********************************/
+
+#include "MembershipSnapshot.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/**
+ * Constructor
+ */
+MembershipSnapshot::MembershipSnapshot(const string &path): path(path), temporaryPath(path + ".tmp") {}
+
+/**
+ * FUNCTION NAME: reserve
+ *
+ * DESCRIPTION: Size the buffer for a table of up to entries members, so writing a snapshot does not allocate
+ */
+void MembershipSnapshot::reserve(size_t entries) {
+	size_t size = sizeof(SnapshotHeader) + entries * (3 * sizeof(int64_t) + sizeof(int32_t) + sizeof(int16_t));
+	if ( buffer.size() < size ) {
+		buffer.resize(size);
+	}
+}
+
+/**
+ * FUNCTION NAME: write
+ *
+ * DESCRIPTION: Write the table, the node's incarnation and the current time to the snapshot file
+ */
+bool MembershipSnapshot::write(MembershipTable &table, long incarnation, long time) {
+	size_t count = table.size();
+	size_t size = sizeof(SnapshotHeader) + count * (3 * sizeof(int64_t) + sizeof(int32_t) + sizeof(int16_t));
+	reserve(count);
+
+	SnapshotHeader *header = (SnapshotHeader *) &buffer[0];
+	memset(header, 0, sizeof(SnapshotHeader));
+	memcpy(header->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+	header->version = SNAPSHOT_VERSION;
+	header->count = count;
+	header->incarnation = incarnation;
+	header->time = time;
+
+	int64_t *heartbeats = (int64_t *) (header + 1);
+	int64_t *timestamps = heartbeats + count;
+	int64_t *incarnations = timestamps + count;
+	int32_t *ids = (int32_t *) (incarnations + count);
+	int16_t *ports = (int16_t *) (ids + count);
+	for ( size_t i = 0; i < count; i++ ) {
+		heartbeats[i] = table.heartbeat(i);
+		timestamps[i] = table.timestamp(i);
+		incarnations[i] = table.incarnation(i);
+		ids[i] = table.id(i);
+		ports[i] = table.port(i);
+	}
+
+	FILE *fp = fopen(temporaryPath.c_str(), "wb");
+	if ( fp == NULL ) {
+		return false;
+	}
+	bool written = fwrite(&buffer[0], 1, size, fp) == size;
+	written = (fclose(fp) == 0) && written;
+	if ( !written ) {
+		unlink(temporaryPath.c_str());
+		return false;
+	}
+	return rename(temporaryPath.c_str(), path.c_str()) == 0;
+}
+
+/**
+ * FUNCTION NAME: read
+ *
+ * DESCRIPTION: Map the snapshot file and copy its entries out.
+ * 				Returns false if there is no snapshot or it is not a valid one.
+ */
+bool MembershipSnapshot::read(vector<MemberListEntry> &entries, long &incarnation, long &time) {
+	int fd = open(path.c_str(), O_RDONLY);
+	if ( fd < 0 ) {
+		return false;
+	}
+	struct stat st;
+	if ( fstat(fd, &st) != 0 || st.st_size < (off_t) sizeof(SnapshotHeader) ) {
+		close(fd);
+		return false;
+	}
+	size_t size = st.st_size;
+	void *mapped = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if ( mapped == MAP_FAILED ) {
+		return false;
+	}
+
+	SnapshotHeader *header = (SnapshotHeader *) mapped;
+	size_t count = header->count;
+	bool valid = memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) == 0
+		&& header->version == SNAPSHOT_VERSION
+		&& size == sizeof(SnapshotHeader) + count * (3 * sizeof(int64_t) + sizeof(int32_t) + sizeof(int16_t));
+	if ( valid ) {
+		int64_t *heartbeats = (int64_t *) (header + 1);
+		int64_t *timestamps = heartbeats + count;
+		int64_t *incarnations = timestamps + count;
+		int32_t *ids = (int32_t *) (incarnations + count);
+		int16_t *ports = (int16_t *) (ids + count);
+		entries.clear();
+		entries.reserve(count);
+		for ( size_t i = 0; i < count; i++ ) {
+			MemberListEntry entry(ids[i], ports[i], heartbeats[i], timestamps[i]);
+			entry.incarnation = incarnations[i];
+			entries.push_back(entry);
+		}
+		incarnation = header->incarnation;
+		time = header->time;
+	}
+	munmap(mapped, size);
+	return valid;
+}
+
+/**
+ * FUNCTION NAME: remove
+ *
+ * DESCRIPTION: Delete the snapshot file
+ */
+void MembershipSnapshot::remove() {
+	unlink(path.c_str());
+}
@@ -17,17 +17,87 @@ Params::Params(): PORTNUM(8001) {}
  * DESCRIPTION: Set the parameters for this test case
  */
 void Params::setparams(char *config_file) {
+	char key[64];
+	char value[64];
 	FILE *fp = fopen(config_file,"r");
 
-	fscanf(fp,"MAX_NNB: %d", &MAX_NNB);
-	fscanf(fp,"\nSINGLE_FAILURE: %d", &SINGLE_FAILURE);
-	fscanf(fp,"\nDROP_MSG: %d", &DROP_MSG);
-	fscanf(fp,"\nMSG_DROP_PROB: %lf", &MSG_DROP_PROB);
+	// Defaults for the keys a test case may leave out
+	MAX_NNB = 10;
+	SINGLE_FAILURE = 0;
+	DROP_MSG = 0;
+	MSG_DROP_PROB = 0;
+	PHI_THRESHOLD = 0;
+	GRACEFUL_LEAVE = 0;
+	INTRODUCERS = 1;
+	GOSSIP_ENTRIES = 0;
+	SNAPSHOT_INTERVAL = 0;
+	RESTART_AFTER = 0;
+	STEP_RATE = .25;
+	ZONES = 1;
+	HIERARCHICAL = 0;
+	CROSS_ZONE_INTERVAL = 2;
+	INTRA_ZONE_LATENCY = 0;
+	CROSS_ZONE_LATENCY = 0;
+	BROADCASTS = 0;
+
+	// Every line of the test case is a "KEY: value" pair
+	while ( fscanf(fp, " %63[^:]: %63s", key, value) == 2 ) {
+		if ( 0 == strcmp(key, "MAX_NNB") ) {
+			MAX_NNB = atoi(value);
+		}
+		else if ( 0 == strcmp(key, "SINGLE_FAILURE") ) {
+			SINGLE_FAILURE = atoi(value);
+		}
+		else if ( 0 == strcmp(key, "DROP_MSG") ) {
+			DROP_MSG = atoi(value);
+		}
+		else if ( 0 == strcmp(key, "MSG_DROP_PROB") ) {
+			MSG_DROP_PROB = atof(value);
+		}
+		else if ( 0 == strcmp(key, "PHI_THRESHOLD") ) {
+			PHI_THRESHOLD = atof(value);
+		}
+		else if ( 0 == strcmp(key, "GRACEFUL_LEAVE") ) {
+			GRACEFUL_LEAVE = atoi(value);
+		}
+		else if ( 0 == strcmp(key, "INTRODUCERS") ) {
+			INTRODUCERS = atoi(value);
+		}
+		else if ( 0 == strcmp(key, "STEP_RATE") ) {
+			STEP_RATE = atof(value);
+		}
+		else if ( 0 == strcmp(key, "GOSSIP_ENTRIES") ) {
+			GOSSIP_ENTRIES = atoi(value);
+		}
+		else if ( 0 == strcmp(key, "SNAPSHOT_INTERVAL") ) {
+			SNAPSHOT_INTERVAL = atoi(value);
+		}
+		else if ( 0 == strcmp(key, "RESTART_AFTER") ) {
+			RESTART_AFTER = atoi(value);
+		}
+		else if ( 0 == strcmp(key, "ZONES") ) {
+			ZONES = atoi(value);
+		}
+		else if ( 0 == strcmp(key, "HIERARCHICAL") ) {
+			HIERARCHICAL = atoi(value);
+		}
+		else if ( 0 == strcmp(key, "CROSS_ZONE_INTERVAL") ) {
+			CROSS_ZONE_INTERVAL = atoi(value);
+		}
+		else if ( 0 == strcmp(key, "INTRA_ZONE_LATENCY") ) {
+			INTRA_ZONE_LATENCY = atoi(value);
+		}
+		else if ( 0 == strcmp(key, "CROSS_ZONE_LATENCY") ) {
+			CROSS_ZONE_LATENCY = atoi(value);
+		}
+		else if ( 0 == strcmp(key, "BROADCASTS") ) {
+			BROADCASTS = atoi(value);
+		}
+	}
 
 	//printf("Parameters of the test case: %d %d %d %lf\n", MAX_NNB, SINGLE_FAILURE, DROP_MSG, MSG_DROP_PROB);
 
 	EN_GPSZ = MAX_NNB;
-	STEP_RATE=.25;
 	MAX_MSG_SIZE = 4000;
 	globaltime = 0;
 	dropmsg = 0;
@@ -35,6 +105,9 @@ void Params::setparams(char *config_file) {
 	for ( unsigned int i = 0; i < EN_GPSZ; i++ ) {
 		allNodesJoined += i;
 	}
+	if ( CROSS_ZONE_INTERVAL < 1 ) {
+		CROSS_ZONE_INTERVAL = 1;
+	}
 	fclose(fp);
 	return;
 }
@@ -48,3 +121,25 @@ void Params::setparams(char *config_file) {
 int Params::getcurrtime(){
     return globaltime;
 }
+
+/**
+ * FUNCTION NAME: zoneOf
+ *
+ * DESCRIPTION: Return the zone of the node with the given id.
+ * 				Nodes are placed in ZONES racks of consecutive ids.
+ */
+int Params::zoneOf(int id) {
+	if ( ZONES <= 1 || EN_GPSZ <= 0 ) {
+		return 0;
+	}
+	return ((id - 1) % EN_GPSZ) * ZONES / EN_GPSZ;
+}
+
+/**
+ * FUNCTION NAME: linkLatency
+ *
+ * DESCRIPTION: Return the number of ticks a message takes from node id from to node id to
+ */
+int Params::linkLatency(int from, int to) {
+	return zoneOf(from) == zoneOf(to) ? INTRA_ZONE_LATENCY : CROSS_ZONE_LATENCY;
+}
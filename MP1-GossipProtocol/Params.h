@@ -27,6 +27,18 @@ public:
 	int EN_GPSZ;			    // actual number of peers
 	int MAX_MSG_SIZE;
 	int DROP_MSG;
+	int INTRODUCERS;			// nodes 1..INTRODUCERS answer join requests
+	int GOSSIP_ENTRIES;			// max member entries per gossip message, 0 for no limit
+	int SNAPSHOT_INTERVAL;		// ticks between membership snapshots, 0 for none
+	int RESTART_AFTER;			// failed nodes restart after this many ticks, 0 for never
+	int GRACEFUL_LEAVE;			// failed nodes announce their departure first
+	double PHI_THRESHOLD;		// phi-accrual suspicion level, 0 keeps the fixed TREMOVE timeout
+	int ZONES;					// nodes are placed in this many zones
+	int HIERARCHICAL;			// gossip inside zones, and across zones through gateways only
+	int CROSS_ZONE_INTERVAL;	// ticks between gossip exchanges across zones
+	int INTRA_ZONE_LATENCY;		// ticks a message takes between nodes of the same zone
+	int CROSS_ZONE_LATENCY;		// ticks a message takes between nodes of different zones
+	int BROADCASTS;				// test broadcasts sent by random nodes, one every 20 ticks from time 60
 	int dropmsg;
 	int globaltime;
 	int allNodesJoined;
@@ -34,6 +46,8 @@ public:
 	Params();
 	void setparams(char *);
 	int getcurrtime();
+	int zoneOf(int id);
+	int linkLatency(int from, int to);
 };
 
 #endif /* _PARAMS_H_ */
@@ -0,0 +1,83 @@
+/**********************************
+ * FILE NAME: Plumtree.h
+ *
+ * DESCRIPTION: Header file of the Plumtree class
+ **********************************/
+
+#ifndef PLUMTREE_H_
+#define PLUMTREE_H_
+
+#include "stdincludes.h"
+
+/**
+ * STRUCT NAME: BroadcastMessage
+ *
+ * DESCRIPTION: A broadcast kept to answer grafts, until it expires
+ */
+struct BroadcastMessage {
+	unsigned long long id;
+	int round;
+	string payload;
+	long expires;
+};
+
+/**
+ * CLASS NAME: Plumtree
+ *
+ * DESCRIPTION: State of the Plumtree epidemic broadcast (Leitao et al.) at one node.
+ * 				Broadcasts are pushed eagerly along a spanning tree formed by the eager peers,
+ * 				and announced lazily to the other peers of the view. A duplicate prunes the link
+ * 				it came over out of the tree, an announced broadcast that does not arrive in time
+ * 				grafts the link it was announced over back in.
+ * 				The view is a uniform sample of the members, so that the tree spans the group.
+ * 				The class only keeps the state, the messages are sent by MP1Node.
+ */
+class Plumtree {
+private:
+	struct Missing {
+		unsigned long long id;
+		// Peers that announced the broadcast, in the order to graft them
+		vector<unsigned long long> announcers;
+		size_t next;
+		long deadline;
+	};
+	size_t capacity;
+	// Members seen so far, for the reservoir sample
+	long seen;
+	vector<unsigned long long> eager;
+	vector<unsigned long long> lazy;
+	// Ring of the kept broadcasts in the order they were received, which is also the order they expire in.
+	// Slots and their payloads are reused, the ring only grows when more broadcasts are kept at once.
+	vector<BroadcastMessage> messages;
+	size_t oldest;
+	size_t kept;
+	size_t payloadSize;
+	// Announced broadcasts that did not arrive, the first missingCount slots are in use
+	vector<Missing> missing;
+	size_t missingCount;
+	// Broadcasts received since the last flush, to announce to the lazy peers
+	vector<unsigned long long> announcements;
+	static bool erase(vector<unsigned long long> &peers, unsigned long long key);
+	void grow(size_t slots);
+	void found(unsigned long long id);
+public:
+	Plumtree(size_t capacity);
+	void reserve(size_t members, size_t slots, size_t payloadSize);
+	bool addPeer(unsigned long long key);
+	bool removePeer(unsigned long long key);
+	bool inView(unsigned long long key);
+	size_t viewSize();
+	void graft(unsigned long long key);
+	void prune(unsigned long long key);
+	const vector<unsigned long long>& eagerPeers();
+	const vector<unsigned long long>& lazyPeers();
+	bool store(unsigned long long id, int round, const char *payload, int size, long expires);
+	const BroadcastMessage *lookup(unsigned long long id);
+	void announced(unsigned long long id, unsigned long long from, long deadline);
+	void timedOut(long now, long retry, vector<pair<unsigned long long, unsigned long long> > &grafts);
+	vector<unsigned long long>& pendingAnnouncements();
+	void expire(long now);
+	void clear();
+};
+
+#endif /* PLUMTREE_H_ */
@@ -0,0 +1,52 @@
+/**********************************
+ * FILE NAME: TimerWheel.h
+ *
+ * DESCRIPTION: Header file of the hierarchical timer wheel
+ **********************************/
+
+#ifndef TIMERWHEEL_H_
+#define TIMERWHEEL_H_
+
+#include "stdincludes.h"
+
+/**
+ * Macros
+ */
+#define WHEEL_BITS 6
+#define WHEEL_SLOTS (1 << WHEEL_BITS)
+#define WHEEL_LEVELS 3
+
+/**
+ * CLASS NAME: TimerWheel
+ *
+ * DESCRIPTION: Hierarchical timer wheel keyed by member. Level 0 has one slot per tick,
+ * 				every further level has slots WHEEL_SLOTS times as wide, and timers cascade
+ * 				down one level when the wheel below wraps around. Scheduling, rescheduling
+ * 				and cancelling are O(1), and advancing only visits timers that are due
+ * 				(plus the occasional cascade). List nodes are recycled, so rescheduling
+ * 				an existing timer does not allocate.
+ */
+class TimerWheel {
+private:
+	typedef list<unsigned long long> Slot;
+	struct Timer {
+		long deadline;
+		Slot *slot;
+		Slot::iterator pos;
+	};
+	Slot slots[WHEEL_LEVELS][WHEEL_SLOTS];
+	Slot spare;
+	unordered_map<unsigned long long, Timer> timers;
+	long now;
+	void place(Timer &timer, long earliest);
+	void cascade(int level);
+public:
+	TimerWheel();
+	void schedule(unsigned long long key, long deadline);
+	void cancel(unsigned long long key);
+	void advance(long time, vector<unsigned long long> &expired);
+	size_t size();
+	void clear(long time);
+};
+
+#endif /* TIMERWHEEL_H_ */
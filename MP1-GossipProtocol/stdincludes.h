@@ -10,7 +10,6 @@
 /*
  * Macros
  */
-#define RING_SIZE 512
 #define FAILURE -1
 #define SUCCESS 0
 
@@ -30,7 +29,9 @@
 #include <signal.h>
 #include <iostream>
 #include <vector>
+#include <list>
 #include <map>
+#include <unordered_map>
 #include <string>
 #include <algorithm>
 #include <queue>
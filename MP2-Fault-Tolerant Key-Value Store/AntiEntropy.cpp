@@ -0,0 +1,128 @@
+/**********************************
+ * FILE NAME: AntiEntropy.cpp
+ *
+ * DESCRIPTION: Definition of the AntiEntropy class
+ **********************************/
+
+#include "AntiEntropy.h"
+
+/**
+ * FUNCTION NAME: rangeOf
+ *
+ * DESCRIPTION: Identifier of the key range with the given replicas. It does not depend on the
+ * 				order of the replicas, a placement may list the same members in a different order
+ * 				for different keys.
+ */
+uint64_t AntiEntropy::rangeOf(const ReplicaSpan &replicas) {
+	uint64_t range = 0;
+	for ( size_t i = 0; i < replicas.size(); i++ ) {
+		range ^= mix64(hash64(replicas[i]->addr, sizeof(replicas[i]->addr)));
+	}
+	return range;
+}
+
+/**
+ * FUNCTION NAME: entryHash
+ *
+ * DESCRIPTION: Hash of a key and the version stored for it, a tombstone included. The replica type
+ * 				is left out, it differs between replicas holding the same version.
+ */
+uint64_t AntiEntropy::entryHash(const string &key, const Entry &entry) {
+	uint64_t version = hash64(key.data(), key.size(), entry.timestamp);
+	return hash64(entry.value.data(), entry.value.size(), entry.deleted ? mix64(version) : version);
+}
+
+/**
+ * FUNCTION NAME: compare
+ *
+ * DESCRIPTION: Total order of the addresses, so that two peers agree which of them drives
+ * 				the exchange of a range they both have
+ */
+int AntiEntropy::compare(const Address &a, const Address &b) {
+	return memcmp(a.addr, b.addr, sizeof(a.addr));
+}
+
+/**
+ * FUNCTION NAME: toggle
+ *
+ * DESCRIPTION: Add the entry to the tree of its range, or remove it if it is in it.
+ * 				Called with the old entry and then the new one when a key is overwritten.
+ */
+void AntiEntropy::toggle(const ReplicaSpan &replicas, const string &key, const Entry &entry) {
+	uint64_t range = rangeOf(replicas);
+	unordered_map<uint64_t, KeyRange>::iterator it = ranges.find(range);
+	if ( it == ranges.end() ) {
+		it = ranges.insert(make_pair(range, KeyRange())).first;
+		for ( size_t i = 0; i < replicas.size(); i++ ) {
+			it->second.replicas.push_back(*replicas[i]);
+		}
+	}
+	it->second.tree.toggle(hash64(key.data(), key.size()), entryHash(key, entry));
+}
+
+/**
+ * FUNCTION NAME: contains
+ *
+ * DESCRIPTION: Returns true if the node stored a key of the range since the last clear
+ */
+bool AntiEntropy::contains(uint64_t range) {
+	return ranges.find(range) != ranges.end();
+}
+
+/**
+ * FUNCTION NAME: tree
+ *
+ * DESCRIPTION: Merkle tree of the range, the empty tree if the node has no keys of it
+ */
+const MerkleTree &AntiEntropy::tree(uint64_t range) {
+	unordered_map<uint64_t, KeyRange>::iterator it = ranges.find(range);
+	return it == ranges.end() ? empty : it->second.tree;
+}
+
+/**
+ * FUNCTION NAME: rangesWith
+ *
+ * DESCRIPTION: Ranges the peer is a replica of
+ */
+void AntiEntropy::rangesWith(const Address &peer, vector<uint64_t> &out) {
+	for ( unordered_map<uint64_t, KeyRange>::iterator it = ranges.begin(); it != ranges.end(); ++it ) {
+		for ( size_t i = 0; i < it->second.replicas.size(); i++ ) {
+			if ( compare(it->second.replicas[i], peer) == 0 ) {
+				out.push_back(it->first);
+				break;
+			}
+		}
+	}
+}
+
+/**
+ * FUNCTION NAME: peers
+ *
+ * DESCRIPTION: Distinct replicas of all the ranges, other than self
+ */
+void AntiEntropy::peers(const Address &self, vector<Address> &out) {
+	for ( unordered_map<uint64_t, KeyRange>::iterator it = ranges.begin(); it != ranges.end(); ++it ) {
+		for ( size_t i = 0; i < it->second.replicas.size(); i++ ) {
+			const Address &replica = it->second.replicas[i];
+			if ( compare(replica, self) == 0 ) {
+				continue;
+			}
+			bool known = false;
+			for ( size_t j = 0; j < out.size() && !known; j++ ) {
+				known = compare(out[j], replica) == 0;
+			}
+			if ( !known ) {
+				out.push_back(replica);
+			}
+		}
+	}
+}
+
+/**
+ * FUNCTION NAME: clear
+ *
+ * DESCRIPTION: Forget every tree, the ranges are rebuilt after a membership change
+ */
+void AntiEntropy::clear() {
+	ranges.clear();
+}
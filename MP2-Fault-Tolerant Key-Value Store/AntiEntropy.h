@@ -0,0 +1,46 @@
+/**********************************
+ * FILE NAME: AntiEntropy.h
+ *
+ * DESCRIPTION: Header file of the AntiEntropy class
+ **********************************/
+
+#ifndef ANTIENTROPY_H_
+#define ANTIENTROPY_H_
+
+#include "stdincludes.h"
+#include "Placement.h"
+#include "MerkleTree.h"
+#include "Entry.h"
+#include "Hash.h"
+
+/**
+ * CLASS NAME: AntiEntropy
+ *
+ * DESCRIPTION: Merkle trees of the keys a node stores, one per key range. A key range is the set
+ * 				of keys with the same replicas, so every replica of a range can build the same tree
+ * 				and two replicas only have to exchange the keys of the leaves where their trees
+ * 				differ. Ranges are identified by the hash of their replicas' addresses.
+ * 				The class only keeps the trees, the exchange is run by MP2Node.
+ */
+class AntiEntropy {
+private:
+	struct KeyRange {
+		vector<Address> replicas;
+		MerkleTree tree;
+	};
+	unordered_map<uint64_t, KeyRange> ranges;
+	// Tree of a range without keys
+	MerkleTree empty;
+public:
+	static uint64_t rangeOf(const ReplicaSpan &replicas);
+	static uint64_t entryHash(const string &key, const Entry &entry);
+	static int compare(const Address &a, const Address &b);
+	void toggle(const ReplicaSpan &replicas, const string &key, const Entry &entry);
+	bool contains(uint64_t range);
+	const MerkleTree &tree(uint64_t range);
+	void rangesWith(const Address &peer, vector<uint64_t> &out);
+	void peers(const Address &self, vector<Address> &out);
+	void clear();
+};
+
+#endif /* ANTIENTROPY_H_ */
@@ -67,6 +67,8 @@ Application::Application(char *infile) {
 		addressOfMemberNode = (Address *) en->ENinit(addressOfMemberNode, par->PORTNUM);
 		mp1[i] = new MP1Node(memberNode, par, en, log, addressOfMemberNode);
 		mp2[i] = new MP2Node(memberNode, par, en1, log, addressOfMemberNode);
+		mp1[i]->addListener(mp2[i]);
+		mp1[i]->setAggregateSource(mp2[i]);
 		log->LOG(&(mp1[i]->getMemberNode()->addr), "APP");
 		log->LOG(&(mp2[i]->getMemberNode()->addr), "APP MP2");
 		delete addressOfMemberNode;
@@ -120,6 +122,8 @@ int Application::run()
 		//fail();
 	}
 
+	reportLoadBalance();
+
 	// Clean up
 	en->ENcleanup();
 	en1->ENcleanup();
@@ -131,6 +135,36 @@ int Application::run()
 	return SUCCESS;
 }
 
+/**
+ * FUNCTION NAME: reportLoadBalance
+ *
+ * DESCRIPTION: Report how evenly the keys are spread over the live nodes: the mean and the
+ * 				standard deviation of the number of keys (replicas included) per node
+ */
+void Application::reportLoadBalance() {
+	int live = 0;
+	long minKeys = -1, maxKeys = 0;
+	double sum = 0, sumSquares = 0;
+	for ( int i = 0; i < par->EN_GPSZ; i++ ) {
+		if ( mp2[i]->getMemberNode()->bFailed ) {
+			continue;
+		}
+		long keys = mp2[i]->keysStored();
+		live++;
+		sum += keys;
+		sumSquares += (double)keys * keys;
+		minKeys = ( minKeys < 0 || keys < minKeys ) ? keys : minKeys;
+		maxKeys = keys > maxKeys ? keys : maxKeys;
+	}
+	if ( live == 0 ) {
+		return;
+	}
+	double mean = sum / live;
+	double stddev = sqrt(max(0.0, sumSquares / live - mean * mean));
+	cout<<"Load balance over "<<live<<" nodes with "<<par->VNODES<<" tokens each: keys per node mean "<<mean<<" stddev "<<stddev<<" min "<<minKeys<<" max "<<maxKeys<<endl;
+	log->LOG(&mp2[0]->getMemberNode()->addr, "Load balance over %d nodes with %d tokens each: keys per node mean %.2f stddev %.2f min %ld max %ld", live, par->VNODES, mean, stddev, minKeys, maxKeys);
+}
+
 /**
  * FUNCTION NAME: mp1Run
  *
@@ -233,7 +267,7 @@ void Application::mp2Run() {
 		 * CREATE TEST
 		 **************/
 		/**
-		 * TEST 1: Checks if there are RF * NUMBER_OF_INSERTS CREATE SUCCESS message are in the log
+		 * TEST 1: Checks if there are REPLICATION_FACTOR * NUMBER_OF_INSERTS CREATE SUCCESS message are in the log
 		 *
 		 */
 		if ( par->getcurrtime() == TEST_TIME && CREATE_TEST == par->CRUDTEST ) {
@@ -245,7 +279,7 @@ void Application::mp2Run() {
 		 ***************/
 		/**
 		 * TEST 1: NUMBER_OF_INSERTS/2 Key Value pair are deleted.
-		 * 		   Check whether RF * NUMBER_OF_INSERTS/2 DELETE SUCCESS message are in the log
+		 * 		   Check whether REPLICATION_FACTOR * NUMBER_OF_INSERTS/2 DELETE SUCCESS message are in the log
 		 * TEST 2: Delete a non-existent key. Check for a DELETE FAIL message in the lgo
 		 *
 		 */
@@ -515,15 +549,16 @@ void Application::readTest() {
 
 		// Step 2.b Find the replicas of this key
 		replicas.clear();
-		replicas = mp2[number]->findNodes(it->first);
+		replicas = mp2[number]->findNodes(it->first).nodes();
 		// if less than quorum replicas are found then exit
-		if ( replicas.size() < (RF-1) ) {
+		if ( (int)replicas.size() < par->READ_QUORUM ) {
 			cout<<endl<<"Could not find at least quorum replicas for this key. Exiting!!! size of replicas vector: "<<replicas.size()<<endl;
 			log->LOG(&mp2[number]->getMemberNode()->addr, "Could not find at least quorum replicas for this key. Exiting!!! size of replicas vector: %d", replicas.size());
 			exit(1);
 		}
 
-		// Step 2.c Fail a replica
+		// Step 2.c Fail a replica, starting from the last one
+		replicaIdToFail = replicas.size() - 1;
 		for ( int i = 0; i < par->EN_GPSZ; i++ ) {
 			if ( mp2[i]->getMemberNode()->addr.getAddress() == replicas.at(replicaIdToFail).getAddress()->getAddress() ) {
 				if ( !mp2[i]->getMemberNode()->bFailed ) {
@@ -582,12 +617,12 @@ void Application::readTest() {
 
 			// Get the keys replicas
 			replicas.clear();
-			replicas = mp2[number]->findNodes(it->first);
+			replicas = mp2[number]->findNodes(it->first).nodes();
 
 			// Step 3.b. Fail two replicas
 			//cout<<"REPLICAS SIZE: "<<replicas.size();
 			if ( replicas.size() > 2 ) {
-				replicaIdToFail = TERTIARY;
+				replicaIdToFail = replicas.size() - 1;
 				while ( count != 2 ) {
 					int i = 0;
 					while ( i != par->EN_GPSZ ) {
@@ -665,12 +700,16 @@ void Application::readTest() {
 
 		// Step 4.b Find a non - replica for this key
 		replicas.clear();
-		replicas = mp2[number]->findNodes(it->first);
+		replicas = mp2[number]->findNodes(it->first).nodes();
 		for ( int i = 0; i < par->EN_GPSZ; i++ ) {
 			if ( !mp2[i]->getMemberNode()->bFailed ) {
-				if ( mp2[i]->getMemberNode()->addr.getAddress() != replicas.at(PRIMARY).getAddress()->getAddress() &&
-					 mp2[i]->getMemberNode()->addr.getAddress() != replicas.at(SECONDARY).getAddress()->getAddress() &&
-					 mp2[i]->getMemberNode()->addr.getAddress() != replicas.at(TERTIARY).getAddress()->getAddress() ) {
+				bool isReplica = false;
+				for ( size_t j = 0; j < replicas.size(); j++ ) {
+					if ( mp2[i]->getMemberNode()->addr.getAddress() == replicas.at(j).getAddress()->getAddress() ) {
+						isReplica = true;
+					}
+				}
+				if ( !isReplica ) {
 					// Step 4.c Fail a non-replica node
 					log->LOG(&mp2[i]->getMemberNode()->addr, "Node failed at time=%d", par->getcurrtime());
 					mp2[i]->getMemberNode()->bFailed = true;
@@ -760,15 +799,16 @@ void Application::updateTest() {
 
 		// Step 2.b Find the replicas of this key
 		replicas.clear();
-		replicas = mp2[number]->findNodes(it->first);
+		replicas = mp2[number]->findNodes(it->first).nodes();
 		// if quorum replicas are not found then exit
-		if ( replicas.size() < RF-1 ) {
+		if ( (int)replicas.size() < par->WRITE_QUORUM ) {
 			log->LOG(&mp2[number]->getMemberNode()->addr, "Could not find at least quorum replicas for this key. Exiting!!! size of replicas vector: %d", replicas.size());
 			cout<<endl<<"Could not find at least quorum replicas for this key. Exiting!!! size of replicas vector: "<<replicas.size()<<endl;
 			exit(1);
 		}
 
-		// Step 2.c Fail a replica
+		// Step 2.c Fail a replica, starting from the last one
+		replicaIdToFail = replicas.size() - 1;
 		for ( int i = 0; i < par->EN_GPSZ; i++ ) {
 			if ( mp2[i]->getMemberNode()->addr.getAddress() == replicas.at(replicaIdToFail).getAddress()->getAddress() ) {
 				if ( !mp2[i]->getMemberNode()->bFailed ) {
@@ -827,11 +867,11 @@ void Application::updateTest() {
 
 			// Get the keys replicas
 			replicas.clear();
-			replicas = mp2[number]->findNodes(it->first);
+			replicas = mp2[number]->findNodes(it->first).nodes();
 
 			// Step 3.b. Fail two replicas
 			if ( replicas.size() > 2 ) {
-				replicaIdToFail = TERTIARY;
+				replicaIdToFail = replicas.size() - 1;
 				while ( count != 2 ) {
 					int i = 0;
 					while ( i != par->EN_GPSZ ) {
@@ -855,7 +895,8 @@ void Application::updateTest() {
 			}
 			else {
 				// If the code reaches here. Test your stabilization protocol
-				cout<<endl<<"Not enough replicas to fail two nodes. Exiting test case !! "<<endl;
+				cout<<endl<<"Not enough replicas to fail two nodes. Number of replicas of this key: " <<replicas.size() <<". Exiting test case !! "<<endl;
+				exit(1);
 			}
 			if ( count == 2 ) {
 				for ( int i = 0; i < nodesToFail.size(); i++ ) {
@@ -907,12 +948,16 @@ void Application::updateTest() {
 
 		// Step 4.b Find a non - replica for this key
 		replicas.clear();
-		replicas = mp2[number]->findNodes(it->first);
+		replicas = mp2[number]->findNodes(it->first).nodes();
 		for ( int i = 0; i < par->EN_GPSZ; i++ ) {
 			if ( !mp2[i]->getMemberNode()->bFailed ) {
-				if ( mp2[i]->getMemberNode()->addr.getAddress() != replicas.at(PRIMARY).getAddress()->getAddress() &&
-					 mp2[i]->getMemberNode()->addr.getAddress() != replicas.at(SECONDARY).getAddress()->getAddress() &&
-					 mp2[i]->getMemberNode()->addr.getAddress() != replicas.at(TERTIARY).getAddress()->getAddress() ) {
+				bool isReplica = false;
+				for ( size_t j = 0; j < replicas.size(); j++ ) {
+					if ( mp2[i]->getMemberNode()->addr.getAddress() == replicas.at(j).getAddress()->getAddress() ) {
+						isReplica = true;
+					}
+				}
+				if ( !isReplica ) {
 					// Step 4.c Fail a non-replica node
 					log->LOG(&mp2[i]->getMemberNode()->addr, "Node failed at time=%d", par->getcurrtime());
 					mp2[i]->getMemberNode()->bFailed = true;
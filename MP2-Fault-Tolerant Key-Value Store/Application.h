@@ -37,7 +37,6 @@ static const char alphanum[] =
 #define STABILIZE_TIME 50
 #define FIRST_FAIL_TIME 25
 #define LAST_FAIL_TIME 10
-#define RF 3
 #define NUMBER_OF_INSERTS 100
 #define KEY_LENGTH 5
 
@@ -72,6 +71,7 @@ public:
 	void deleteTest();
 	void readTest();
 	void updateTest();
+	void reportLoadBalance();
 };
 
 #endif /* _APPLICATION_H__ */
@@ -0,0 +1,87 @@
+/**********************************
+ * FILE NAME: Arena.cpp
+ *
+ * DESCRIPTION: Definition of the Arena class
+ **********************************/
+
+#include "Arena.h"
+
+/**
+ * Constructor
+ */
+Arena::Arena(): usedBytes(0), reservedBytes(0) {}
+
+/**
+ * Destructor
+ */
+Arena::~Arena() {
+	clear();
+}
+
+/**
+ * FUNCTION NAME: append
+ *
+ * DESCRIPTION: Append the record made of the bytes of a followed by the bytes of b, and return where
+ * 				it starts. A new segment is allocated when the last one is full.
+ */
+void Arena::append(const char *a, size_t aSize, const char *b, size_t bSize, uint32_t &segment, uint32_t &offset) {
+	size_t size = aSize + bSize;
+	if ( segments.empty() || segments.back().size - segments.back().used < size ) {
+		Segment fresh;
+		fresh.size = (uint32_t)max(size, (size_t)ARENA_SEGMENT_SIZE);
+		fresh.used = 0;
+		fresh.data = new char[fresh.size];
+		segments.push_back(fresh);
+		reservedBytes += fresh.size;
+	}
+	Segment &last = segments.back();
+	segment = (uint32_t)(segments.size() - 1);
+	offset = last.used;
+	memcpy(last.data + last.used, a, aSize);
+	memcpy(last.data + last.used + aSize, b, bSize);
+	last.used += size;
+	usedBytes += size;
+}
+
+/**
+ * FUNCTION NAME: used
+ *
+ * DESCRIPTION: Bytes appended so far, dead records included
+ */
+size_t Arena::used() const {
+	return usedBytes;
+}
+
+/**
+ * FUNCTION NAME: reserved
+ *
+ * DESCRIPTION: Bytes allocated for the segments
+ */
+size_t Arena::reserved() const {
+	return reservedBytes;
+}
+
+/**
+ * FUNCTION NAME: clear
+ *
+ * DESCRIPTION: Free every segment
+ */
+void Arena::clear() {
+	for ( size_t i = 0; i < segments.size(); i++ ) {
+		delete[] segments[i].data;
+	}
+	segments.clear();
+	usedBytes = 0;
+	reservedBytes = 0;
+}
+
+/**
+ * FUNCTION NAME: swap
+ *
+ * DESCRIPTION: Exchange the contents of the two arenas
+ */
+void Arena::swap(Arena &another) {
+	segments.swap(another.segments);
+	std::swap(usedBytes, another.usedBytes);
+	std::swap(reservedBytes, another.reservedBytes);
+}
@@ -0,0 +1,52 @@
+/**********************************
+ * FILE NAME: Arena.h
+ *
+ * DESCRIPTION: Header file of the Arena class
+ **********************************/
+
+#ifndef ARENA_H_
+#define ARENA_H_
+
+#include "stdincludes.h"
+#include <stdint.h>
+
+// Bytes per segment, records larger than that get a segment of their own
+#define ARENA_SEGMENT_SIZE (64 * 1024)
+
+/**
+ * CLASS NAME: Arena
+ *
+ * DESCRIPTION: Append-only byte storage. Records are appended to the last segment and
+ * 				addressed by (segment, offset), which stay valid until the arena is cleared.
+ * 				A record never straddles two segments, segments are never moved or resized.
+ */
+class Arena {
+private:
+	struct Segment {
+		char *data;
+		uint32_t size;
+		uint32_t used;
+	};
+	vector<Segment> segments;
+	size_t usedBytes;
+	size_t reservedBytes;
+public:
+	Arena();
+	void append(const char *a, size_t aSize, const char *b, size_t bSize, uint32_t &segment, uint32_t &offset);
+	char *at(uint32_t segment, uint32_t offset) {
+		return segments[segment].data + offset;
+	}
+	const char *at(uint32_t segment, uint32_t offset) const {
+		return segments[segment].data + offset;
+	}
+	size_t used() const;
+	size_t reserved() const;
+	void clear();
+	void swap(Arena &another);
+	~Arena();
+private:
+	Arena(const Arena &);
+	Arena &operator=(const Arena &);
+};
+
+#endif /* ARENA_H_ */
@@ -0,0 +1,72 @@
+/**********************************
+ * FILE NAME: BoundedLoadRing.cpp
+ *
+ * DESCRIPTION: Definition of the BoundedLoadRing class
+ **********************************/
+
+#include "BoundedLoadRing.h"
+
+// Size of the hash space
+#define HASH_SPACE 18446744073709551616.0
+
+/**
+ * Constructor
+ */
+BoundedLoadRing::BoundedLoadRing(size_t replicas, int tokensPerNode, double loadFactor): Ring(replicas, tokensPerNode), loadFactor(loadFactor < 1 ? 1 : loadFactor) {}
+
+/**
+ * FUNCTION NAME: rebuild
+ *
+ * DESCRIPTION: Recompute the positions and assign the replicas of the segments to the members
+ * 				under the load bound
+ */
+void BoundedLoadRing::rebuild() {
+	size_t n = nodes.size();
+	tokens.resize(n);
+	preference.resize(n * replicas);
+	for ( size_t i = 0; i < n; i++ ) {
+		tokens[i] = nodes[i].getHashCode();
+	}
+	if ( members < replicas ) {
+		return;
+	}
+
+	// Member of every token, as an index in distinct
+	vector<Address> distinct;
+	vector<size_t> owner(n);
+	for ( size_t i = 0; i < n; i++ ) {
+		size_t m = 0;
+		while ( m < distinct.size() && !(distinct[m] == *nodes[i].getAddress()) ) {
+			m++;
+		}
+		if ( m == distinct.size() ) {
+			distinct.push_back(*nodes[i].getAddress());
+		}
+		owner[i] = m;
+	}
+
+	// Every segment is stored once per replica, the loads add up to replicas
+	vector<double> load(distinct.size(), 0);
+	double capacity = loadFactor * replicas / distinct.size();
+	for ( size_t i = 0; i < n; i++ ) {
+		// The segment ending at token i starts after the previous token, the first one wraps around
+		double share = (double)(tokens[i] - tokens[(i + n - 1) % n]) / HASH_SPACE;
+		Address *list = &preference[i * replicas];
+		size_t found = 0;
+		size_t j = i;
+		do {
+			size_t m = owner[j];
+			size_t r = 0;
+			while ( r < found && !(list[r] == distinct[m]) ) {
+				r++;
+			}
+			if ( r == found && load[m] < capacity ) {
+				list[found++] = distinct[m];
+				load[m] += share;
+			}
+			j = (j + 1) % n;
+		} while ( found < replicas && j != i );
+		// Every member is full, the remaining replicas go over the bound
+		successors(list, found, i);
+	}
+}
@@ -0,0 +1,32 @@
+/**********************************
+ * FILE NAME: BoundedLoadRing.h
+ *
+ * DESCRIPTION: Header file of the BoundedLoadRing class
+ **********************************/
+
+#ifndef BOUNDEDLOADRING_H_
+#define BOUNDEDLOADRING_H_
+
+#include "Ring.h"
+
+/**
+ * CLASS NAME: BoundedLoadRing
+ *
+ * DESCRIPTION: Consistent hashing with bounded loads (Mirrokni et al.). The segments between
+ * 				tokens are the balls: going around the ring, each replica of a segment is given
+ * 				to the next distinct member clockwise whose load is still below loadFactor times
+ * 				the mean load. The load of a member is the fraction of the hash space it stores,
+ * 				which tracks its number of keys as key hashes are uniform, so every node computes
+ * 				the same assignment from the membership alone.
+ * 				Works best with several tokens per member, a segment is never split.
+ */
+class BoundedLoadRing : public Ring {
+private:
+	double loadFactor;
+protected:
+	void rebuild();
+public:
+	BoundedLoadRing(size_t replicas, int tokensPerNode, double loadFactor);
+};
+
+#endif /* BOUNDEDLOADRING_H_ */
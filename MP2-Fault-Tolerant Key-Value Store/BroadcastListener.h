@@ -0,0 +1,24 @@
+/**********************************
+ * FILE NAME: BroadcastListener.h
+ *
+ * DESCRIPTION: Interface for the receivers of cluster-wide broadcasts
+ **********************************/
+
+#ifndef BROADCASTLISTENER_H_
+#define BROADCASTLISTENER_H_
+
+#include "Member.h"
+
+/**
+ * CLASS NAME: BroadcastListener
+ *
+ * DESCRIPTION: Handed every broadcast MP1Node delivers, once, including the ones this node sent.
+ * 				origin is the node that sent the broadcast.
+ */
+class BroadcastListener {
+public:
+	virtual void broadcastDelivered(Address *origin, const string &payload) = 0;
+	virtual ~BroadcastListener() {}
+};
+
+#endif /* BROADCASTLISTENER_H_ */
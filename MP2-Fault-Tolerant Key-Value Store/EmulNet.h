@@ -27,6 +27,8 @@ typedef struct en_msg {
 	Address from;
 	// Destination node
 	Address to;
+	// First time the destination may receive it, see Params::linkLatency
+	int deliverAt;
 }en_msg;
 
 /**
@@ -82,6 +84,11 @@ private:
 	Params* par;
 	int sent_msgs[MAX_NODES + 1][MAX_TIME];
 	int recv_msgs[MAX_NODES + 1][MAX_TIME];
+	// payload bytes sent and received by each node over the whole run
+	long sent_bytes[MAX_NODES + 1];
+	long recv_bytes[MAX_NODES + 1];
+	// payload bytes sent between nodes of different zones
+	long cross_zone_bytes;
 	int enInited;
 	EM emulnet;
 public:
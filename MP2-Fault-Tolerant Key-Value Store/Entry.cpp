@@ -8,34 +8,30 @@
 /**
  * constructor
  */
-Entry::Entry(string _value, int _timestamp, ReplicaType _replica){
+Entry::Entry(string _value, uint64_t _timestamp, ReplicaType _replica, bool _deleted){
 	this->delimiter = ":";
 	value = _value;
 	timestamp = _timestamp;
 	replica = _replica;
+	deleted = _deleted;
 }
 
 /**
  * constructor
  *
  * DESCRIPTION: Convert string to get an Entry object
+ * 				The fields are split from the end, so the value may contain the delimiter
  */
 Entry::Entry(string entry){
-	vector<string> tuple;
 	this->delimiter = ":";
-	size_t pos = entry.find(delimiter);
-	size_t start = 0;
-	while (pos != string::npos) {
-		string field = entry.substr(start, pos-start);
-		tuple.push_back(field);
-		start = pos + delimiter.size();
-		pos = entry.find(delimiter, start);
-	}
-	tuple.push_back(entry.substr(start));
+	size_t deletedPos = entry.rfind(delimiter);
+	size_t replicaPos = entry.rfind(delimiter, deletedPos - 1);
+	size_t timestampPos = entry.rfind(delimiter, replicaPos - 1);
 
-	value = tuple.at(0);
-	timestamp = stoi(tuple.at(1));
-	replica = static_cast<ReplicaType>(stoi(tuple.at(2)));
+	value = entry.substr(0, timestampPos);
+	timestamp = stoull(entry.substr(timestampPos + 1, replicaPos - timestampPos - 1));
+	replica = static_cast<ReplicaType>(stoi(entry.substr(replicaPos + 1, deletedPos - replicaPos - 1)));
+	deleted = entry.compare(deletedPos + 1, string::npos, "1") == 0;
 }
 
 /**
@@ -43,6 +39,18 @@ Entry::Entry(string entry){
  *
  * DESCRIPTION: Convert the object to a string representation
  */
-string Entry::convertToString() {
-	return value + delimiter + to_string(timestamp) + delimiter + to_string(replica);
+string Entry::convertToString() const {
+	return value + delimiter + to_string(timestamp) + delimiter + to_string(replica) + delimiter + (deleted ? "1" : "0");
+}
+
+/**
+ * FUNCTION NAME: newerThan
+ *
+ * DESCRIPTION: Returns true if this entry wins over the other one. Writes with the same
+ * 				timestamp are ordered by value, so every replica picks the same winner.
+ */
+bool Entry::newerThan(const Entry &other) const {
+	if (timestamp != other.timestamp)
+		return timestamp > other.timestamp;
+	return value > other.value;
 }
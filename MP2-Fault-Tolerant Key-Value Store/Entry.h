@@ -4,6 +4,9 @@
  * DESCRIPTION: Header file Entry class
  **********************************/
 
+#ifndef ENTRY_H_
+#define ENTRY_H_
+
 #include "stdincludes.h"
 #include "Message.h"
 
@@ -11,15 +14,23 @@
  * CLASS NAME: Entry
  *
  * DESCRIPTION: This class describes the entry for each key in the DHT
+ * 				The timestamp is the hybrid logical clock of the write that stored the value,
+ * 				replicas keep the newest one (last writer wins)
+ * 				A delete stores a tombstone: an entry with an empty value and the deleted flag,
+ * 				so that older copies of the key are not brought back by repairs
  */
 class Entry{
 public:
 	string value;
-	int timestamp;
+	uint64_t timestamp;
 	ReplicaType replica;
+	bool deleted;
 	string delimiter;
 
 	Entry(string entry);
-	Entry(string _value, int _timestamp, ReplicaType _replica);
-	string convertToString();
+	Entry(string _value, uint64_t _timestamp, ReplicaType _replica, bool _deleted = false);
+	string convertToString() const;
+	bool newerThan(const Entry &other) const;
 };
+
+#endif /* ENTRY_H_ */
@@ -0,0 +1,57 @@
+/**********************************
+ * FILE NAME: FailureDetector.h
+ *
+ * DESCRIPTION: Header file of the phi-accrual failure detector
+ **********************************/
+
+#ifndef FAILUREDETECTOR_H_
+#define FAILUREDETECTOR_H_
+
+#include "stdincludes.h"
+
+/**
+ * Macros
+ */
+// number of inter-arrival samples kept per member
+#define PHI_WINDOW 32
+// assumed heartbeat interval (in ticks) before any sample is known
+#define PHI_BOOTSTRAP_INTERVAL 1.0
+
+/**
+ * CLASS NAME: ArrivalWindow
+ *
+ * DESCRIPTION: Sliding window of heartbeat inter-arrival times of one member
+ */
+class ArrivalWindow {
+public:
+	long lastArrival;
+	long intervals[PHI_WINDOW];
+	int count;
+	int next;
+	long sum;
+	ArrivalWindow(long now);
+	void add(long now);
+	double mean();
+};
+
+/**
+ * CLASS NAME: PhiAccrualDetector
+ *
+ * DESCRIPTION: Tracks heartbeat arrivals per member and turns the time since the last one
+ * 				into a suspicion level phi. Inter-arrival times are modelled as exponentially
+ * 				distributed, so phi = -log10(P(no heartbeat for t)) = log10(e) * t / mean.
+ * 				A member whose links drop messages has a larger mean and is given more slack.
+ */
+class PhiAccrualDetector {
+private:
+	unordered_map<unsigned long long, ArrivalWindow> windows;
+public:
+	PhiAccrualDetector() {}
+	void heartbeat(unsigned long long key, long now);
+	double phi(unsigned long long key, long now);
+	long deadline(unsigned long long key, double threshold);
+	void remove(unsigned long long key);
+	void clear();
+};
+
+#endif /* FAILUREDETECTOR_H_ */
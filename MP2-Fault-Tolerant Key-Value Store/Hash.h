@@ -0,0 +1,27 @@
+/**********************************
+ * FILE NAME: Hash.h
+ *
+ * DESCRIPTION: 64-bit hash functions used to place keys and nodes on the ring
+ **********************************/
+
+#ifndef HASH_H_
+#define HASH_H_
+
+#include "stdincludes.h"
+#include <stdint.h>
+
+/**
+ * FUNCTION NAME: hash64
+ *
+ * DESCRIPTION: XXH64 (xxHash, 64-bit variant) of the len bytes at data
+ */
+uint64_t hash64(const void *data, size_t len, uint64_t seed = 0);
+
+/**
+ * FUNCTION NAME: mix64
+ *
+ * DESCRIPTION: Finalizer of splitmix64, scrambles a 64-bit value into a well distributed one
+ */
+uint64_t mix64(uint64_t x);
+
+#endif /* HASH_H_ */
@@ -5,25 +5,209 @@
  **********************************/
 
 #include "HashTable.h"
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
-HashTable::HashTable() {}
+// Control bytes of the slots without a key, full slots hold 7 bits of the hash (0..127)
+#define CTRL_EMPTY ((signed char)0x80)
+#define CTRL_DELETED ((signed char)0xFE)
+
+// The high bits of the hash pick the group, the low 7 bits go into the control byte
+static inline size_t groupOf(uint64_t hash) {
+	return (size_t)(hash >> 7);
+}
+
+static inline signed char tagOf(uint64_t hash) {
+	return (signed char)(hash & 0x7F);
+}
+
+/**
+ * FUNCTION NAME: matchTag
+ *
+ * DESCRIPTION: Bit i is set if control byte i of the group equals tag
+ */
+static inline unsigned matchTag(const signed char *group, signed char tag) {
+#ifdef __SSE2__
+	__m128i ctrl = _mm_loadu_si128((const __m128i *)group);
+	return (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(tag)));
+#else
+	unsigned mask = 0;
+	for ( int i = 0; i < GROUP_WIDTH; i++ ) {
+		mask |= (unsigned)(group[i] == tag) << i;
+	}
+	return mask;
+#endif
+}
+
+/**
+ * FUNCTION NAME: matchFree
+ *
+ * DESCRIPTION: Bit i is set if slot i of the group is empty or deleted (control byte negative)
+ */
+static inline unsigned matchFree(const signed char *group) {
+#ifdef __SSE2__
+	return (unsigned)_mm_movemask_epi8(_mm_loadu_si128((const __m128i *)group));
+#else
+	unsigned mask = 0;
+	for ( int i = 0; i < GROUP_WIDTH; i++ ) {
+		mask |= (unsigned)(group[i] < 0) << i;
+	}
+	return mask;
+#endif
+}
+
+HashTable::HashTable(): groupMask(0), size(0), deleted(0), deadBytes(0) {
+	rehash(1);
+}
 
 HashTable::~HashTable() {}
 
+/**
+ * FUNCTION NAME: findSlot
+ *
+ * DESCRIPTION: Probes the groups for the key, returns its slot or slots.size() if it is not in the table.
+ * 				Groups are probed in triangular order, which visits every group as their number is a
+ * 				power of two. A group with an empty slot ends the probe.
+ */
+size_t HashTable::findSlot(const char *key, size_t len, uint64_t hash) const {
+	signed char tag = tagOf(hash);
+	size_t group = groupOf(hash) & groupMask;
+	for ( size_t step = 1; step <= groupMask + 1; step++ ) {
+		const signed char *controls = &ctrl[group * GROUP_WIDTH];
+		for ( unsigned mask = matchTag(controls, tag); mask; mask &= mask - 1 ) {
+			size_t i = group * GROUP_WIDTH + __builtin_ctz(mask);
+			if ( slots[i].keySize == len && memcmp(keyOf(slots[i]), key, len) == 0 ) {
+				return i;
+			}
+		}
+		if ( matchTag(controls, CTRL_EMPTY) ) {
+			break;
+		}
+		group = (group + step) & groupMask;
+	}
+	return slots.size();
+}
+
+/**
+ * FUNCTION NAME: freeSlot
+ *
+ * DESCRIPTION: First empty or deleted slot along the probe sequence of the hash
+ */
+size_t HashTable::freeSlot(uint64_t hash) const {
+	size_t group = groupOf(hash) & groupMask;
+	for ( size_t step = 1; ; step++ ) {
+		unsigned mask = matchFree(&ctrl[group * GROUP_WIDTH]);
+		if ( mask ) {
+			return group * GROUP_WIDTH + __builtin_ctz(mask);
+		}
+		group = (group + step) & groupMask;
+	}
+}
+
+/**
+ * FUNCTION NAME: rehash
+ *
+ * DESCRIPTION: Move the entries into a table of the given number of groups, a power of two,
+ * 				dropping the deleted slots. The bytes stay where they are in the arena.
+ */
+void HashTable::rehash(size_t groups) {
+	vector<signed char> oldCtrl(groups * GROUP_WIDTH, CTRL_EMPTY);
+	vector<Slot> oldSlots(groups * GROUP_WIDTH);
+	oldCtrl.swap(ctrl);
+	oldSlots.swap(slots);
+	groupMask = groups - 1;
+	deleted = 0;
+	for ( size_t i = 0; i < oldSlots.size(); i++ ) {
+		if ( oldCtrl[i] < 0 ) {
+			continue;
+		}
+		uint64_t hash = hash64(keyOf(oldSlots[i]), oldSlots[i].keySize);
+		size_t j = freeSlot(hash);
+		ctrl[j] = tagOf(hash);
+		slots[j] = oldSlots[i];
+	}
+}
+
+/**
+ * FUNCTION NAME: retire
+ *
+ * DESCRIPTION: Account for bytes of the arena that are not referred to anymore, and compact
+ * 				the arena once they are half of it
+ */
+void HashTable::retire(size_t bytes) {
+	deadBytes += bytes;
+	if ( deadBytes >= ARENA_SEGMENT_SIZE && deadBytes * 2 >= arena.used() ) {
+		compact();
+	}
+}
+
+/**
+ * FUNCTION NAME: compact
+ *
+ * DESCRIPTION: Copy the live keys and values into a new arena and free the old one
+ */
+void HashTable::compact() {
+	Arena live;
+	for ( size_t i = 0; i < slots.size(); i++ ) {
+		if ( ctrl[i] < 0 ) {
+			continue;
+		}
+		const char *key = keyOf(slots[i]);
+		live.append(key, slots[i].keySize, key + slots[i].keySize, slots[i].valueSize, slots[i].segment, slots[i].offset);
+	}
+	arena.swap(live);
+	deadBytes = 0;
+}
+
+/**
+ * FUNCTION NAME: memoryUsage
+ *
+ * DESCRIPTION: Bytes allocated by the table: control bytes, slots and arena segments
+ */
+size_t HashTable::memoryUsage() const {
+	return ctrl.capacity() + slots.capacity() * sizeof(Slot) + arena.reserved();
+}
+
 /**
  * FUNCTION NAME: create
  *
  * DESCRIPTION: This function inserts they (key,value) pair into the local hash table
+ * 				An existing value of the key is kept
  *
  * RETURNS:
  * true on SUCCESS
  * false in FAILURE
  */
-bool HashTable::create(string key, string value) {
-	hashTable.emplace(key, value);
+bool HashTable::create(const string &key, const string &value) {
+	uint64_t hash = hash64(key.data(), key.size());
+	if ( findSlot(key.data(), key.size(), hash) == slots.size() ) {
+		insert(key, value, hash);
+	}
 	return true;
 }
 
+/**
+ * FUNCTION NAME: insert
+ *
+ * DESCRIPTION: Store a key that is not in the table, growing the table if needed
+ */
+void HashTable::insert(const string &key, const string &value, uint64_t hash) {
+	// Keep the load, deleted slots included, under 7/8
+	if ( (size + deleted + 1) * 8 > slots.size() * 7 ) {
+		rehash((size + 1) * 16 > slots.size() * 7 ? 2 * (groupMask + 1) : groupMask + 1);
+	}
+	size_t i = freeSlot(hash);
+	if ( ctrl[i] == CTRL_DELETED ) {
+		deleted--;
+	}
+	ctrl[i] = tagOf(hash);
+	arena.append(key.data(), key.size(), value.data(), value.size(), slots[i].segment, slots[i].offset);
+	slots[i].keySize = key.size();
+	slots[i].valueSize = value.size();
+	size++;
+}
+
 /**
  * FUNCTION NAME: read
  *
@@ -33,18 +217,29 @@ bool HashTable::create(string key, string value) {
  * string value if found
  * else it returns a NULL
  */
-string HashTable::read(string key) {
-	map<string, string>::iterator search;
+string HashTable::read(const string &key) {
+	StringRef value = find(key);
+	return value.data ? value.str() : "";
+}
 
-	search = hashTable.find(key);
-	if ( search != hashTable.end() ) {
-		// Value found
-		return search->second;
-	}
-	else {
-		// Value not found
-		return "";
+/**
+ * FUNCTION NAME: find
+ *
+ * DESCRIPTION: Looks the key up without copying it or its value
+ *
+ * RETURNS:
+ * the bytes of the value, valid until the table is modified, with a NULL data if not found
+ */
+StringRef HashTable::find(const char *key, size_t len) const {
+	size_t i = findSlot(key, len, hash64(key, len));
+	if ( i == slots.size() ) {
+		return StringRef(NULL, 0);
 	}
+	return StringRef(keyOf(slots[i]) + len, slots[i].valueSize);
+}
+
+StringRef HashTable::find(const string &key) const {
+	return find(key.data(), key.size());
 }
 
 /**
@@ -57,20 +252,39 @@ string HashTable::read(string key) {
  * true on SUCCESS
  * false on FAILURE
  */
-bool HashTable::update(string key, string newValue) {
-	map<string, string>::iterator update;
-
-	if (read(key).empty()) {
+bool HashTable::update(const string &key, const string &newValue) {
+	size_t i = findSlot(key.data(), key.size(), hash64(key.data(), key.size()));
+	if ( i == slots.size() ) {
 		// Key not found
 		return false;
 	}
-	// Key found
-	//update = hashTable.at(key) = newValue;
-	hashTable.at(key) = newValue;
+	assign(i, key, newValue);
 	// Update successful
 	return true;
 }
 
+/**
+ * FUNCTION NAME: assign
+ *
+ * DESCRIPTION: Replace the value of the key in slot i
+ */
+void HashTable::assign(size_t i, const string &key, const string &newValue) {
+	Slot &slot = slots[i];
+	if ( newValue.size() <= slot.valueSize ) {
+		// The new value fits in place of the old one
+		memcpy(arena.at(slot.segment, slot.offset) + slot.keySize, newValue.data(), newValue.size());
+		size_t shrunk = slot.valueSize - newValue.size();
+		slot.valueSize = newValue.size();
+		retire(shrunk);
+	}
+	else {
+		size_t old = slot.keySize + slot.valueSize;
+		arena.append(key.data(), key.size(), newValue.data(), newValue.size(), slot.segment, slot.offset);
+		slot.valueSize = newValue.size();
+		retire(old);
+	}
+}
+
 /**
  * FUNCTION NAME: deleteKey
  *
@@ -80,18 +294,23 @@ bool HashTable::update(string key, string newValue) {
  * true on SUCCESS
  * false on FAILURE
  */
-bool HashTable::deleteKey(string key) {
-	uint eraseCount = 0;
-
-	if (read(key).empty()) {
+bool HashTable::deleteKey(const string &key) {
+	size_t i = findSlot(key.data(), key.size(), hash64(key.data(), key.size()));
+	if ( i == slots.size() ) {
 		// Key not found
 		return false;
 	}
-	eraseCount = hashTable.erase(key);
-	if ( eraseCount < 1 ) {
-		// Could not erase
-		return false;
+	// A slot whose group still has an empty slot never continued a probe, it can be empty again
+	size_t group = i / GROUP_WIDTH;
+	if ( matchTag(&ctrl[group * GROUP_WIDTH], CTRL_EMPTY) ) {
+		ctrl[i] = CTRL_EMPTY;
 	}
+	else {
+		ctrl[i] = CTRL_DELETED;
+		deleted++;
+	}
+	size--;
+	retire(slots[i].keySize + slots[i].valueSize);
 	// Delete was successful
 	return true;
 }
@@ -106,7 +325,7 @@ bool HashTable::deleteKey(string key) {
  * false otherwise
  */
 bool HashTable::isEmpty() {
-	return hashTable.empty();
+	return size == 0;
 }
 
 /**
@@ -118,7 +337,7 @@ bool HashTable::isEmpty() {
  * size of the table as unit
  */
 unsigned long HashTable::currentSize() {
-	return (unsigned  long)hashTable.size();
+	return (unsigned long)size;
 }
 
 /**
@@ -127,7 +346,12 @@ unsigned long HashTable::currentSize() {
  * DESCRIPTION: Clear all contents from the hash table
  */
 void HashTable::clear() {
-	hashTable.clear();
+	ctrl.clear();
+	slots.clear();
+	arena.clear();
+	size = 0;
+	deadBytes = 0;
+	rehash(1);
 }
 
 /**
@@ -138,7 +362,6 @@ void HashTable::clear() {
  * RETURNS:
  * unsigned long count (Should be always 1)
  */
-unsigned long HashTable::count(string key) {
-	return (unsigned long) hashTable.count(key);
+unsigned long HashTable::count(const string &key) {
+	return find(key).data ? 1 : 0;
 }
-
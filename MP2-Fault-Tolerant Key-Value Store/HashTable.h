@@ -13,26 +13,109 @@
 #include "stdincludes.h"
 #include "common.h"
 #include "Entry.h"
+#include "Hash.h"
+#include "Arena.h"
+
+// Slots per group of control bytes, probed together
+#define GROUP_WIDTH 16
 
 /**
- * CLASS NAME: HashTable
+ * STRUCT NAME: StringRef
  *
- * DESCRIPTION: This class is a wrapper to the map provided by C++ STL.
+ * DESCRIPTION: Non-owning reference to bytes stored in the table, valid until the table is modified.
+ * 				data is NULL for a key that is not in the table.
+ */
+struct StringRef {
+	const char *data;
+	size_t size;
+	StringRef(const char *data, size_t size): data(data), size(size) {}
+	string str() const {
+		return string(data, size);
+	}
+};
+
+/**
+ * CLASS NAME: HashTable
  *
+ * DESCRIPTION: Open addressing hash table in the style of Swiss tables.
+ * 				A control byte per slot holds 7 bits of the hash of its key, or marks the slot
+ * 				empty or deleted. Lookups probe groups of GROUP_WIDTH control bytes at a time
+ * 				(with SSE2 where available) and only compare the keys whose 7 bits match.
+ * 				The bytes of every key and its value are appended, back to back, to an arena;
+ * 				a slot only holds where they are, 16 bytes. Updates that grow a value and deletes
+ * 				leave dead bytes behind, the arena is compacted once they make up half of it.
+ * 				Lookups take the key as a byte range, so callers holding a char buffer do not
+ * 				need to build a string.
  */
 class HashTable {
+private:
+	struct Slot {
+		uint32_t segment;
+		uint32_t offset;
+		uint32_t keySize;
+		uint32_t valueSize;
+	};
+	// One control byte per slot
+	vector<signed char> ctrl;
+	vector<Slot> slots;
+	Arena arena;
+	size_t groupMask;
+	size_t size;
+	// Deleted slots, counted against the load factor until the next rehash
+	size_t deleted;
+	// Bytes of the arena no slot refers to anymore
+	size_t deadBytes;
+	size_t findSlot(const char *key, size_t len, uint64_t hash) const;
+	size_t freeSlot(uint64_t hash) const;
+	void rehash(size_t groups);
+	void retire(size_t bytes);
+	void insert(const string &key, const string &value, uint64_t hash);
+	void assign(size_t i, const string &key, const string &value);
+	const char *keyOf(const Slot &slot) const {
+		return arena.at(slot.segment, slot.offset);
+	}
 public:
-	map<string, string> hashTable;
-//public:
 	HashTable();
-	bool create(string key, string value);
-	string read(string key);
-	bool update(string key, string newValue);
-	bool deleteKey(string key);
+	bool create(const string &key, const string &value);
+	string read(const string &key);
+	StringRef find(const char *key, size_t len) const;
+	StringRef find(const string &key) const;
+	bool update(const string &key, const string &newValue);
+	bool deleteKey(const string &key);
+	// Looks the key up once and calls f(old, value), old with a NULL data if the key is missing.
+	// If f returns true, value is stored for the key. Returns what f returned.
+	template <typename F> bool upsert(const string &key, F f) {
+		uint64_t hash = hash64(key.data(), key.size());
+		size_t i = findSlot(key.data(), key.size(), hash);
+		bool found = i != slots.size();
+		string value;
+		StringRef old = found ? StringRef(keyOf(slots[i]) + slots[i].keySize, slots[i].valueSize) : StringRef(NULL, 0);
+		if ( !f(old, value) ) {
+			return false;
+		}
+		if ( found ) {
+			assign(i, key, value);
+		}
+		else {
+			insert(key, value, hash);
+		}
+		return true;
+	}
 	bool isEmpty();
 	unsigned long currentSize();
 	void clear();
-	unsigned long count(string key);
+	unsigned long count(const string &key);
+	void compact();
+	size_t memoryUsage() const;
+	// Calls f(key, value) for every entry, in no particular order, with StringRefs
+	template <typename F> void forEach(F f) const {
+		for ( size_t i = 0; i < slots.size(); i++ ) {
+			if ( ctrl[i] >= 0 ) {
+				const char *key = keyOf(slots[i]);
+				f(StringRef(key, slots[i].keySize), StringRef(key + slots[i].keySize, slots[i].valueSize));
+			}
+		}
+	}
 	virtual ~HashTable();
 };
 
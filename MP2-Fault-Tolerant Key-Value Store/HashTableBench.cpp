@@ -0,0 +1,132 @@
+/**********************************
+ * FILE NAME: HashTableBench.cpp
+ *
+ * DESCRIPTION: Benchmark of the local key-value table.
+ * 				Compares the open addressing HashTable with the std::map wrapper it replaced,
+ * 				for creates, reads, updates and deletes of 1K to 10M keys, in random order, and
+ * 				counts the allocator calls per create and the heap bytes per entry.
+ * 				Build and run with "make bench", or "./HashTableBench <max keys>".
+ **********************************/
+
+#include "HashTable.h"
+#include <chrono>
+#include <malloc.h>
+
+// Calls to operator new
+static size_t allocCalls = 0;
+
+void *operator new(size_t size) {
+	allocCalls++;
+	void *p = malloc(size);
+	if ( !p ) {
+		throw bad_alloc();
+	}
+	return p;
+}
+
+void operator delete(void *p) noexcept {
+	free(p);
+}
+
+static size_t heapInUse() {
+	return mallinfo2().uordblks;
+}
+
+/**
+ * CLASS NAME: MapTable
+ *
+ * DESCRIPTION: The previous HashTable, a wrapper of std::map where update and delete read the
+ * 				value first
+ */
+class MapTable {
+public:
+	map<string, string> hashTable;
+	bool create(string key, string value) {
+		hashTable.emplace(key, value);
+		return true;
+	}
+	string read(string key) {
+		map<string, string>::iterator search = hashTable.find(key);
+		return search != hashTable.end() ? search->second : "";
+	}
+	bool update(string key, string newValue) {
+		if ( read(key).empty() ) {
+			return false;
+		}
+		hashTable.at(key) = newValue;
+		return true;
+	}
+	bool deleteKey(string key) {
+		if ( read(key).empty() ) {
+			return false;
+		}
+		return hashTable.erase(key) > 0;
+	}
+};
+
+static double elapsed(chrono::steady_clock::time_point start) {
+	return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * FUNCTION NAME: bench
+ *
+ * DESCRIPTION: time every operation once per key, and check every one of them succeeded
+ */
+template <typename Table> static void bench(const char *name, const vector<string> &keys, const vector<string> &values, const vector<size_t> &order) {
+	size_t heap = heapInUse();
+	Table *table = new Table();
+	size_t n = keys.size();
+	size_t ok = 0;
+	chrono::steady_clock::time_point start;
+	double seconds[4];
+
+	size_t calls = allocCalls;
+	start = chrono::steady_clock::now();
+	for ( size_t i = 0; i < n; i++ ) {
+		ok += table->create(keys[order[i]], values[order[i]]);
+	}
+	seconds[0] = elapsed(start);
+	calls = allocCalls - calls;
+	heap = heapInUse() - heap;
+
+	start = chrono::steady_clock::now();
+	for ( size_t i = 0; i < n; i++ ) {
+		ok += table->read(keys[i]).size() == values[i].size();
+	}
+	seconds[1] = elapsed(start);
+
+	start = chrono::steady_clock::now();
+	for ( size_t i = 0; i < n; i++ ) {
+		ok += table->update(keys[order[n - 1 - i]], values[i]);
+	}
+	seconds[2] = elapsed(start);
+
+	start = chrono::steady_clock::now();
+	for ( size_t i = 0; i < n; i++ ) {
+		ok += table->deleteKey(keys[i]);
+	}
+	seconds[3] = elapsed(start);
+
+	printf("%-10s %9zu keys  create %7.1f ns  read %7.1f ns  update %7.1f ns  delete %7.1f ns  %6.3f allocs/create  %5.1f bytes/entry\n",
+		name, n, seconds[0] * 1e9 / n, seconds[1] * 1e9 / n, seconds[2] * 1e9 / n, seconds[3] * 1e9 / n, (double)calls / n, (double)heap / n);
+	assert(ok == 4 * n);
+	delete table;
+}
+
+int main(int argc, char *argv[]) {
+	size_t maxKeys = argc > 1 ? strtoul(argv[1], NULL, 10) : 10000000;
+	for ( size_t n = 1000; n <= maxKeys; n *= 10 ) {
+		vector<string> keys(n), values(n);
+		vector<size_t> order(n);
+		for ( size_t i = 0; i < n; i++ ) {
+			keys[i] = "key" + to_string(i);
+			values[i] = "value" + to_string(i % 1000);
+			order[i] = i;
+		}
+		random_shuffle(order.begin(), order.end());
+		bench<MapTable>("std::map", keys, values, order);
+		bench<HashTable>("HashTable", keys, values, order);
+	}
+	return 0;
+}
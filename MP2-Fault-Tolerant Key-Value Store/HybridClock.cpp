@@ -0,0 +1,43 @@
+/**********************************
+ * FILE NAME: HybridClock.cpp
+ *
+ * DESCRIPTION: Definition of the HybridClock class
+ **********************************/
+
+#include "HybridClock.h"
+
+/**
+ * Constructor
+ */
+HybridClock::HybridClock(): last(0) {}
+
+/**
+ * FUNCTION NAME: now
+ *
+ * DESCRIPTION: Timestamp for a local event, such as a write this node coordinates.
+ * 				Within one physical tick the logical counter orders the events,
+ * 				it carries into the physical bits if it overflows.
+ */
+uint64_t HybridClock::now(long physical) {
+	last = max(last + 1, (uint64_t)physical << HLC_LOGICAL_BITS);
+	return last;
+}
+
+/**
+ * FUNCTION NAME: update
+ *
+ * DESCRIPTION: Merge the timestamp of a received message, so that the next local
+ * 				timestamps come after it
+ */
+void HybridClock::update(long physical, uint64_t remote) {
+	last = max(max(last, remote), (uint64_t)physical << HLC_LOGICAL_BITS);
+}
+
+/**
+ * FUNCTION NAME: physicalTime
+ *
+ * DESCRIPTION: Physical time the timestamp was taken at
+ */
+long HybridClock::physicalTime(uint64_t timestamp) {
+	return (long)(timestamp >> HLC_LOGICAL_BITS);
+}
@@ -0,0 +1,34 @@
+/**********************************
+ * FILE NAME: HybridClock.h
+ *
+ * DESCRIPTION: Header file of the HybridClock class
+ **********************************/
+
+#ifndef HYBRIDCLOCK_H_
+#define HYBRIDCLOCK_H_
+
+#include "stdincludes.h"
+#include <stdint.h>
+
+// Low bits of a timestamp that hold the logical counter
+#define HLC_LOGICAL_BITS 16
+
+/**
+ * CLASS NAME: HybridClock
+ *
+ * DESCRIPTION: Hybrid logical clock (Kulkarni et al.). A timestamp packs the physical time in
+ * 				the high bits and a logical counter in the low HLC_LOGICAL_BITS bits, so timestamps
+ * 				compare as plain integers. They follow the physical time, never go backwards, and
+ * 				are larger than every timestamp the node received before issuing them.
+ */
+class HybridClock {
+private:
+	uint64_t last;
+public:
+	HybridClock();
+	uint64_t now(long physical);
+	void update(long physical, uint64_t remote);
+	static long physicalTime(uint64_t timestamp);
+};
+
+#endif /* HYBRIDCLOCK_H_ */
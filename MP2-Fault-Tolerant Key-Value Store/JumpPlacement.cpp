@@ -0,0 +1,128 @@
+/**********************************
+ * FILE NAME: JumpPlacement.cpp
+ *
+ * DESCRIPTION: Definition of the JumpPlacement class
+ **********************************/
+
+#include "JumpPlacement.h"
+
+// Jumps tried before falling back to a scan of the buckets
+#define MAX_JUMPS 64
+
+/**
+ * Constructor
+ */
+JumpPlacement::JumpPlacement(size_t replicas): Placement(replicas), members(0), picked(this->replicas), chosen(this->replicas) {}
+
+/**
+ * FUNCTION NAME: jump
+ *
+ * DESCRIPTION: Jump consistent hash of the key over numBuckets buckets
+ */
+int JumpPlacement::jump(uint64_t key, int numBuckets) {
+	int64_t b = -1, j = 0;
+	while ( j < numBuckets ) {
+		b = j;
+		key = key * 2862933555777941757ULL + 1;
+		j = (int64_t)((b + 1) * (double(1LL << 31) / double((key >> 33) + 1)));
+	}
+	return (int)b;
+}
+
+/**
+ * FUNCTION NAME: bucketOf
+ *
+ * DESCRIPTION: Bucket of the member, from the id in its address
+ */
+int JumpPlacement::bucketOf(Address *addr) {
+	int id = 0;
+	memcpy(&id, &addr->addr[0], sizeof(int));
+	return id - 1;
+}
+
+/**
+ * FUNCTION NAME: insert
+ *
+ * DESCRIPTION: Add the member, growing the range of buckets up to its id
+ */
+void JumpPlacement::insert(Address *addr) {
+	int b = bucketOf(addr);
+	if ( b < 0 ) {
+		return;
+	}
+	if ( (size_t)b >= buckets.size() ) {
+		buckets.resize(b + 1);
+		alive.resize(b + 1, 0);
+	}
+	if ( !alive[b] ) {
+		alive[b] = 1;
+		members++;
+	}
+	buckets[b] = *addr;
+}
+
+/**
+ * FUNCTION NAME: remove
+ *
+ * DESCRIPTION: Remove the member, shrinking the range of buckets to the highest live id.
+ * 				Returns false if it was not a member.
+ */
+bool JumpPlacement::remove(Address *addr) {
+	int b = bucketOf(addr);
+	if ( b < 0 || (size_t)b >= buckets.size() || !alive[b] || !(buckets[b] == *addr) ) {
+		return false;
+	}
+	alive[b] = 0;
+	members--;
+	while ( !alive.empty() && !alive.back() ) {
+		alive.pop_back();
+		buckets.pop_back();
+	}
+	return true;
+}
+
+/**
+ * FUNCTION NAME: size
+ *
+ * DESCRIPTION: Number of members
+ */
+size_t JumpPlacement::size() {
+	return members;
+}
+
+/**
+ * FUNCTION NAME: replicasOf
+ *
+ * DESCRIPTION: The members of the first distinct live buckets the key jumps to, one per replica
+ */
+ReplicaSpan JumpPlacement::replicasOf(uint64_t position) {
+	if ( members < replicas ) {
+		return ReplicaSpan(NULL, 0);
+	}
+	size_t found = 0;
+	uint64_t key = position;
+	for ( int attempt = 0; found < replicas && attempt < MAX_JUMPS; attempt++ ) {
+		int b = jump(key, buckets.size());
+		size_t r = 0;
+		while ( r < found && picked[r] != b ) {
+			r++;
+		}
+		if ( alive[b] && r == found ) {
+			picked[found] = b;
+			chosen[found++] = buckets[b];
+		}
+		key = mix64(key + attempt + 1);
+	}
+	// Only reached with very few live buckets in a wide range
+	for ( size_t b = 0; found < replicas && b < buckets.size(); b++ ) {
+		size_t r = 0;
+		while ( r < found && picked[r] != (int)b ) {
+			r++;
+		}
+		if ( alive[b] && r == found ) {
+			picked[found] = b;
+			chosen[found++] = buckets[b];
+		}
+	}
+	return ReplicaSpan(&chosen[0], replicas);
+}
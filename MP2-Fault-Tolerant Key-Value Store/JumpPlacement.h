@@ -0,0 +1,42 @@
+/**********************************
+ * FILE NAME: JumpPlacement.h
+ *
+ * DESCRIPTION: Header file of the JumpPlacement class
+ **********************************/
+
+#ifndef JUMPPLACEMENT_H_
+#define JUMPPLACEMENT_H_
+
+#include "Placement.h"
+
+/**
+ * CLASS NAME: JumpPlacement
+ *
+ * DESCRIPTION: Jump consistent hash (Lamping and Veach). Jump hash maps a key to one of
+ * 				a range of numbered buckets and only supports growing or shrinking the range
+ * 				at its end, so the buckets are the member ids (id 1 is bucket 0) up to the
+ * 				highest id present. A key whose bucket has no live member, or a member already
+ * 				chosen, is rehashed and jumped again, which keeps the keys of the other members
+ * 				in place when a member in the middle of the range fails.
+ * 				The span returned by replicasOf points into a buffer reused by the next lookup.
+ */
+class JumpPlacement : public Placement {
+private:
+	// Member of every bucket, valid where alive is set
+	vector<Address> buckets;
+	vector<char> alive;
+	size_t members;
+	// Buckets and members of the last lookup
+	vector<int> picked;
+	vector<Address> chosen;
+	static int bucketOf(Address *addr);
+public:
+	JumpPlacement(size_t replicas);
+	static int jump(uint64_t key, int numBuckets);
+	void insert(Address *addr);
+	bool remove(Address *addr);
+	size_t size();
+	ReplicaSpan replicasOf(uint64_t position);
+};
+
+#endif /* JUMPPLACEMENT_H_ */
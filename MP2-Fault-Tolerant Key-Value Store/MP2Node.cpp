@@ -8,7 +8,7 @@
 /**
  * constructor
  */
-Transaction::Transaction(int transactionID, MessageType type, string key, string value, int timestamp) {
+Transaction::Transaction(int transactionID, MessageType type, string key, string value, int timestamp, int quorum) {
 	this->id = transactionID;
 	this->msgType = type;
 	this->key = key;
@@ -16,6 +16,10 @@ Transaction::Transaction(int transactionID, MessageType type, string key, string
 	this->timestamp = timestamp;
 	this->replyCount = 0;
 	this->successCount = 0;
+	this->quorum = quorum;
+	this->version = 0;
+	this->replicas = 0;
+	this->decided = false;
 }
 
 /**
@@ -28,6 +32,14 @@ MP2Node::MP2Node(Member *memberNode, Params *par, EmulNet * emulNet, Log * log,
 	this->log = log;
 	ht = new HashTable();
 	this->memberNode->addr = *address;
+	ring = Placement::create(par->PLACEMENT, par->REPLICATION_FACTOR, par->VNODES, par->LOAD_FACTOR);
+	ring->insert(&this->memberNode->addr);
+	previousRing = Placement::create(par->PLACEMENT, par->REPLICATION_FACTOR, par->VNODES, par->LOAD_FACTOR);
+	previousRing->insert(&this->memberNode->addr);
+	ringChanged = true;
+	handledMessages = 0;
+	servedRequests = 0;
+	tombstoneCount = 0;
 }
 
 /**
@@ -35,6 +47,8 @@ MP2Node::MP2Node(Member *memberNode, Params *par, EmulNet * emulNet, Log * log,
  */
 MP2Node::~MP2Node() {
 	delete ht;
+	delete ring;
+	delete previousRing;
 	delete memberNode;
 	map<int, Transaction*>::iterator it = transactionMap.begin();
 	while(it != transactionMap.end()){
@@ -47,74 +61,76 @@ MP2Node::~MP2Node() {
  * FUNCTION NAME: updateRing
  *
  * DESCRIPTION: This function does the following:
- * 				1) Gets the current membership list from the Membership Protocol (MP1Node)
- * 				   The membership list is returned as a vector of Nodes. See Node class in Node.h
- * 				2) Constructs the ring based on the membership list
- * 				3) Calls the Stabilization Protocol
+ * 				1) Nothing is rebuilt from the membership list of the Membership Protocol (MP1Node):
+ * 				   memberJoined and memberLeft patch the ring as MP1Node reports the changes,
+ * 				   in the order they happen
+ * 				2) Drops the delete tombstones older than TDELETE
+ * 				3) Calls the Stabilization Protocol if the ring changed since the last call,
+ * 				   then replays the changes on the previous ring
  */
 void MP2Node::updateRing() {
-	/*
-	 * Implement this. Parts of it are already implemented
-	 */
-	vector<Node> curMemList;
-	bool change = false;
-
-	/*
-	 *  Step 1. Get the current membership list from Membership Protocol / MP1
-	 */
-	curMemList = getMembershipList();
-	curMemList.emplace_back(Node(memberNode->addr));
-
-	/*
-	 * Step 2: Construct the ring
-	 */
-	// Sort the list based on the hashCode
-	sort(curMemList.begin(), curMemList.end());
+	expireTombstones();
+	if(!ringChanged)
+		return;
+	ringChanged = false;
+	stabilizationProtocol();
+	for(size_t i=0; i<ringChanges.size(); ++i){
+		if(ringChanges[i].second)
+			previousRing->insert(&ringChanges[i].first);
+		else
+			previousRing->remove(&ringChanges[i].first);
+	}
+	ringChanges.clear();
+}
 
+/**
+ * FUNCTION NAME: memberJoined
+ *
+ * DESCRIPTION: Insert the new member into the ring, keeping it sorted by hash code
+ */
+void MP2Node::memberJoined(Address *addr, long version) {
+	ring->insert(addr);
+	ringChanges.push_back(make_pair(*addr, true));
+	ringChanged = true;
+}
 
-	/*
-	 * Step 3: Run the stabilization protocol IF REQUIRED
-	 */
-	// Run stabilization protocol if the hash table size is greater than zero and if there has been a changed in the ring
-	int ringSize = ring.size();
-	if(curMemList.size() != ringSize) {
-		change = true;
-	} else if(ringSize > 0){
-		for(int i=0; i<ringSize; ++i) {
-			if(curMemList[i].getHashCode() != ring[i].getHashCode()){
-				change = true;
-				break;
-			}
-		}
+/**
+ * FUNCTION NAME: memberLeft
+ *
+ * DESCRIPTION: Remove the member from the ring
+ */
+void MP2Node::memberLeft(Address *addr, long version) {
+	if(ring->remove(addr)) {
+		ringChanges.push_back(make_pair(*addr, false));
+		ringChanged = true;
 	}
+}
 
-	ring = curMemList;
-	if(change)
-		stabilizationProtocol();
+/**
+ * FUNCTION NAME: messagesHandled
+ *
+ * DESCRIPTION: Number of key-value store messages this node handled so far
+ */
+long MP2Node::messagesHandled() {
+	return handledMessages;
 }
 
 /**
- * FUNCTION NAME: getMembershipList
+ * FUNCTION NAME: requestsServed
  *
- * DESCRIPTION: This function goes through the membership list from the Membership protocol/MP1 and
- * 				i) generates the hash code for each member
- * 				ii) populates the ring member in MP2Node class
- * 				It returns a vector of Nodes. Each element in the vector contain the following fields:
- * 				a) Address of the node
- * 				b) Hash code obtained by consistent hashing of the Address
+ * DESCRIPTION: Number of client requests this node coordinated so far
  */
-vector<Node> MP2Node::getMembershipList() {
-	unsigned int i;
-	vector<Node> curMemList;
-	for ( i = 0 ; i < this->memberNode->memberList.size(); i++ ) {
-		Address addressOfThisMember;
-		int id = this->memberNode->memberList.at(i).getid();
-		short port = this->memberNode->memberList.at(i).getport();
-		memcpy(&addressOfThisMember.addr[0], &id, sizeof(int));
-		memcpy(&addressOfThisMember.addr[4], &port, sizeof(short));
-		curMemList.emplace_back(Node(addressOfThisMember));
-	}
-	return curMemList;
+long MP2Node::requestsServed() {
+	return servedRequests;
+}
+
+/**
+ * FUNCTION NAME: keysStored
+ *
+ * DESCRIPTION: Number of keys in the local hash table, replicas included and tombstones left out
+ */
+long MP2Node::keysStored() {
+	return ht->currentSize() - tombstoneCount;
 }
 
 /**
@@ -124,12 +140,10 @@ vector<Node> MP2Node::getMembershipList() {
  * 				HASH FUNCTION USED FOR CONSISTENT HASHING
  *
  * RETURNS:
- * size_t position on the ring
+ * uint64_t position on the ring
  */
-size_t MP2Node::hashFunction(string key) {
-	std::hash<string> hashFunc;
-	size_t ret = hashFunc(key);
-	return ret%RING_SIZE;
+uint64_t MP2Node::hashFunction(const string &key) {
+	return hash64(key.data(), key.size());
 }
 
 /**
@@ -137,15 +151,17 @@ size_t MP2Node::hashFunction(string key) {
  *
  * DESCRIPTION: client side CREATE API
  * 				The function does the following:
- * 				1) Constructs the message
+ * 				1) Constructs the message, stamped with the hybrid logical clock
  * 				2) Finds the replicas of this key
  * 				3) Sends a message to the replica
  */
 void MP2Node::clientCreate(string key, string value) {
+	++servedRequests;
 	Message msg = createMessage(MessageType::CREATE, key, value);
-	std::vector<Node> replicas = findNodes(key);
-	for(int i=0; i<replicas.size(); ++i){
-		emulNet->ENsend(&memberNode->addr, replicas[i].getAddress(), msg.toString());
+	ReplicaSpan replicas = findNodes(key);
+	for(size_t i=0; i<replicas.size(); ++i){
+		msg.replica = static_cast<ReplicaType>(min(i, (size_t)TERTIARY));
+		emulNet->ENsend(&memberNode->addr, replicas[i], msg.toString());
 	}
 	++g_transID;
 }
@@ -160,10 +176,11 @@ void MP2Node::clientCreate(string key, string value) {
  * 				3) Sends a message to the replica
  */
 void MP2Node::clientRead(string key){
+	++servedRequests;
 	Message msg = createMessage(MessageType::READ, key);
-	std::vector<Node> replicas = findNodes(key);
-	for(int i=0; i<replicas.size(); ++i){
-		emulNet->ENsend(&memberNode->addr, replicas[i].getAddress(), msg.toString());
+	ReplicaSpan replicas = findNodes(key);
+	for(size_t i=0; i<replicas.size(); ++i){
+		emulNet->ENsend(&memberNode->addr, replicas[i], msg.toString());
 	}
 	++g_transID;
 }
@@ -173,15 +190,17 @@ void MP2Node::clientRead(string key){
  *
  * DESCRIPTION: client side UPDATE API
  * 				The function does the following:
- * 				1) Constructs the message
+ * 				1) Constructs the message, stamped with the hybrid logical clock
  * 				2) Finds the replicas of this key
  * 				3) Sends a message to the replica
  */
 void MP2Node::clientUpdate(string key, string value){
+	++servedRequests;
 	Message msg = createMessage(MessageType::UPDATE, key, value);
-	std::vector<Node> replicas = findNodes(key);
-	for(int i=0; i<replicas.size(); ++i){
-		emulNet->ENsend(&memberNode->addr, replicas[i].getAddress(), msg.toString());
+	ReplicaSpan replicas = findNodes(key);
+	for(size_t i=0; i<replicas.size(); ++i){
+		msg.replica = static_cast<ReplicaType>(min(i, (size_t)TERTIARY));
+		emulNet->ENsend(&memberNode->addr, replicas[i], msg.toString());
 	}
 	++g_transID;
 }
@@ -191,38 +210,125 @@ void MP2Node::clientUpdate(string key, string value){
  *
  * DESCRIPTION: client side DELETE API
  * 				The function does the following:
- * 				1) Constructs the message
+ * 				1) Constructs the message, stamped with the hybrid logical clock
  * 				2) Finds the replicas of this key
  * 				3) Sends a message to the replica
  */
 void MP2Node::clientDelete(string key){
+	++servedRequests;
 	Message msg = createMessage(MessageType::DELETE, key);
-	std::vector<Node> replicas = findNodes(key);
-	for(int i=0; i<replicas.size(); ++i){
-		emulNet->ENsend(&memberNode->addr, replicas[i].getAddress(), msg.toString());
+	ReplicaSpan replicas = findNodes(key);
+	for(size_t i=0; i<replicas.size(); ++i){
+		emulNet->ENsend(&memberNode->addr, replicas[i], msg.toString());
 	}
 	++g_transID;
 }
 
+/**
+ * FUNCTION NAME: applyWrite
+ *
+ * DESCRIPTION: Store the entry unless the local one is newer (last writer wins).
+ * 				A missing or deleted key is only written by a create. Returns false if the key is
+ * 				missing or deleted and the write is an update or a delete, true otherwise, also when
+ * 				the write lost: it was applied, a newer write just superseded it.
+ * 				A stored tombstone is queued to expire TDELETE ticks after the delete.
+ */
+bool MP2Node::applyWrite(const string &key, const Entry &entry, bool create) {
+	bool live = false;
+	Entry previous("", 0, PRIMARY);
+	bool found = false;
+	bool stored = ht->upsert(key, [&](StringRef old, string &value) {
+		found = old.data != NULL;
+		if(found) {
+			previous = Entry(old.str());
+			live = !previous.deleted;
+		}
+		if(found && !entry.newerThan(previous))
+			return false;
+		if(!live && !create)
+			return false;
+		value = entry.convertToString();
+		return true;
+	});
+	if(stored) {
+		if(found) {
+			trackEntry(key, previous);
+			if(previous.deleted)
+				--tombstoneCount;
+		}
+		trackEntry(key, entry);
+		if(entry.deleted) {
+			++tombstoneCount;
+			tombstones.push(make_pair(entry.timestamp, key));
+		}
+	}
+	return live || create;
+}
+
+/**
+ * FUNCTION NAME: expireTombstones
+ *
+ * DESCRIPTION: Remove the tombstones of the deletes older than TDELETE ticks from the hash table.
+ * 				A tombstone overwritten by a newer write since is only dropped from the queue.
+ */
+void MP2Node::expireTombstones() {
+	while(!tombstones.empty() && HybridClock::physicalTime(tombstones.top().first) + TDELETE <= par->getcurrtime()) {
+		uint64_t timestamp = tombstones.top().first;
+		string key = tombstones.top().second;
+		tombstones.pop();
+		string stored = ht->read(key);
+		if(stored.empty())
+			continue;
+		Entry entry(stored);
+		if(!entry.deleted || entry.timestamp != timestamp)
+			continue;
+		ht->deleteKey(key);
+		trackEntry(key, entry);
+		--tombstoneCount;
+	}
+}
+
+/**
+ * FUNCTION NAME: replicaIndex
+ *
+ * DESCRIPTION: Position of the address in the replicas, -1 if it is not one of them
+ */
+int MP2Node::replicaIndex(const ReplicaSpan &replicas, Address *addr) {
+	for(size_t i=0; i<replicas.size(); ++i){
+		if(*replicas[i] == *addr)
+			return i;
+	}
+	return -1;
+}
+
+/**
+ * FUNCTION NAME: trackEntry
+ *
+ * DESCRIPTION: Toggle the entry in the Merkle tree of its key range, if this node is one
+ * 				of the replicas of the key
+ */
+void MP2Node::trackEntry(const string &key, const Entry &entry) {
+	ReplicaSpan replicas = findNodes(key);
+	if(replicaIndex(replicas, &memberNode->addr) >= 0)
+		antiEntropy.toggle(replicas, key, entry);
+}
+
 /**
  * FUNCTION NAME: createKeyValue
  *
  * DESCRIPTION: Server side CREATE API
  * 			   	The function does the following:
- * 			   	1) Inserts key value into the local hash table
+ * 			   	1) Inserts key value into the local hash table, keeping the newest version
+ * 			   	   if the key is already there (retried create or stabilization)
  * 			   	2) Return true or false based on success or failure
  */
-bool MP2Node::createKeyValue(string key, string value, ReplicaType replica, int transactionID) {
-	bool success = false;
+bool MP2Node::createKeyValue(string key, string value, ReplicaType replica, int transactionID, uint64_t timestamp) {
+	bool success = applyWrite(key, Entry(value, timestamp, replica), true);
 	if(transactionID != STABLE) {
-		success = ht->create(key, value);
 		if(success)
 			log->logCreateSuccess(&memberNode->addr, false, transactionID, key, value);
 		else
 			log->logCreateFail(&memberNode->addr, false, transactionID, key, value);
-	} else {
-		if(ht->read(key) == "")
-			success = ht->create(key, value);
 	}
 	return success;
 }
@@ -233,15 +339,16 @@ bool MP2Node::createKeyValue(string key, string value, ReplicaType replica, int
  * DESCRIPTION: Server side READ API
  * 			    This function does the following:
  * 			    1) Read key from local hash table
- * 			    2) Return value
+ * 			    2) Return the entry, with an empty value if the key is missing
  */
-string MP2Node::readKey(string key, int transactionID) {
-	string value = ht->read(key);
-	if(value != "")
-		log->logReadSuccess(&memberNode->addr, false, transactionID, key, value);
+Entry MP2Node::readKey(string key, int transactionID) {
+	string stored = ht->read(key);
+	Entry entry = stored.empty() ? Entry("", 0, PRIMARY) : Entry(stored);
+	if(entry.value != "")
+		log->logReadSuccess(&memberNode->addr, false, transactionID, key, entry.value);
 	else
 		log->logReadFail(&memberNode->addr, false, transactionID, key);
-	return value;
+	return entry;
 }
 
 /**
@@ -249,11 +356,12 @@ string MP2Node::readKey(string key, int transactionID) {
  *
  * DESCRIPTION: Server side UPDATE API
  * 				This function does the following:
- * 				1) Update the key to the new value in the local hash table
+ * 				1) Update the key to the new value in the local hash table,
+ * 				   unless the local version is newer
  * 				2) Return true or false based on success or failure
  */
-bool MP2Node::updateKeyValue(string key, string value, ReplicaType replica, int transactionID) {
-	bool success = ht->update(key, value);
+bool MP2Node::updateKeyValue(string key, string value, ReplicaType replica, int transactionID, uint64_t timestamp) {
+	bool success = applyWrite(key, Entry(value, timestamp, replica), false);
 	if(success)
 		log->logUpdateSuccess(&memberNode->addr, false, transactionID, key, value);
 	else
@@ -266,11 +374,17 @@ bool MP2Node::updateKeyValue(string key, string value, ReplicaType replica, int
  *
  * DESCRIPTION: Server side DELETE API
  * 				This function does the following:
- * 				1) Delete the key from the local hash table
+ * 				1) Replace the key in the local hash table by a tombstone stamped with the delete,
+ * 				   unless the local version is newer. A stabilization delete also stores the
+ * 				   tombstone of a key missing here, unless it already expired.
  * 				2) Return true or false based on success or failure
  */
-bool MP2Node::deletekey(string key, int transactionID) {
-	bool success = ht->deleteKey(key);
+bool MP2Node::deletekey(string key, int transactionID, uint64_t timestamp) {
+	bool success = false;
+	if(transactionID != STABLE)
+		success = applyWrite(key, Entry("", timestamp, PRIMARY, true), false);
+	else if(HybridClock::physicalTime(timestamp) + TDELETE > par->getcurrtime())
+		success = applyWrite(key, Entry("", timestamp, PRIMARY, true), true);
 	if(transactionID != STABLE){
 		if(success)
 			log->logDeleteSuccess(&memberNode->addr, false, transactionID, key);
@@ -288,6 +402,7 @@ bool MP2Node::deletekey(string key, int transactionID) {
  * 				1) Pops messages from the queue
  * 				2) Handles the messages according to message types
  * 				3) Ensure all READ and UPDATE operation get QUORUM replies.
+ * 				   Reads wait for READ_QUORUM replies, the other operations for WRITE_QUORUM.
  */
 void MP2Node::checkMessages() {
 	/*
@@ -308,30 +423,33 @@ void MP2Node::checkMessages() {
 		data = (char *)memberNode->mp2q.front().elt;
 		size = memberNode->mp2q.front().size;
 		memberNode->mp2q.pop();
+		++handledMessages;
 
 		string message(data, data + size);
 		Message msg(message);
+		if(msg.timestamp != 0)
+			clock.update(par->getcurrtime(), msg.timestamp);
 
 		switch(msg.type) {
 			case MessageType::CREATE: {
-				bool success = createKeyValue(msg.key, msg.value, msg.replica, msg.transID);
+				bool success = createKeyValue(msg.key, msg.value, msg.replica, msg.transID, msg.timestamp);
 				if(msg.transID != STABLE)
 					sendReply(&msg.fromAddr, msg.transID, success, msg.type, msg.key);
 				break;
 			}
 			case MessageType::READ: {
-				string value = readKey(msg.key, msg.transID);
-				bool success = !value.empty();
-				sendReply(&msg.fromAddr, msg.transID, success, msg.type, msg.key, value);
+				Entry entry = readKey(msg.key, msg.transID);
+				bool success = !entry.value.empty();
+				sendReply(&msg.fromAddr, msg.transID, success, msg.type, msg.key, entry.value, entry.timestamp);
 				break;
 			}
 			case MessageType::UPDATE: {
-				bool success = updateKeyValue(msg.key, msg.value, msg.replica, msg.transID);
+				bool success = updateKeyValue(msg.key, msg.value, msg.replica, msg.transID, msg.timestamp);
 				sendReply(&msg.fromAddr, msg.transID, success, msg.type, msg.key);
 				break;
 			}
 			case MessageType::DELETE: {
-				bool success = deletekey(msg.key, msg.transID);
+				bool success = deletekey(msg.key, msg.transID, msg.timestamp);
 				if(msg.transID != STABLE)
 					sendReply(&msg.fromAddr, msg.transID, success, msg.type, msg.key);
 				break;				
@@ -346,14 +464,35 @@ void MP2Node::checkMessages() {
 				}
 				break;					
 			}
+			case MessageType::SYNCROOTS: {
+				handleSync(msg);
+				break;
+			}
+			case MessageType::SYNCLEAVES: {
+				handleSyncLeaves(msg);
+				break;
+			}
+			case MessageType::SYNCPULL: {
+				handleSyncPull(msg);
+				break;
+			}
 			case MessageType::READREPLY: {
 				map<int, Transaction*>::iterator it = transactionMap.find(msg.transID);
 				if(it != transactionMap.end()) { //Found
-					Transaction* t = transactionMap[msg.transID];
+					Transaction* t = it->second;
 					t->replyCount ++;
-					t->value = msg.value;
-					if(!msg.value.empty())
+					Entry reply(msg.value, msg.timestamp, PRIMARY);
+					t->replies.push_back(make_pair(msg.fromAddr, reply));
+					// Keep the newest version the replicas returned
+					if(!msg.value.empty()) {
+						if(t->successCount == 0 || reply.newerThan(Entry(t->value, t->version, PRIMARY))) {
+							t->value = msg.value;
+							t->version = msg.timestamp;
+						}
 						t->successCount ++;
+					}
+					if(t->decided)
+						readRepair(t);
 				}
 				break;				
 			}						
@@ -365,33 +504,12 @@ void MP2Node::checkMessages() {
 /**
  * FUNCTION NAME: findNodes
  *
- * DESCRIPTION: Find the replicas of the given keyfunction
- * 				This function is responsible for finding the replicas of a key
- */
-vector<Node> MP2Node::findNodes(string key) {
-	size_t pos = hashFunction(key);
-	vector<Node> addr_vec;
-	if (ring.size() >= 3) {
-		// if pos <= min || pos > max, the leader is the min
-		if (pos <= ring.at(0).getHashCode() || pos > ring.at(ring.size()-1).getHashCode()) {
-			addr_vec.emplace_back(ring.at(0));
-			addr_vec.emplace_back(ring.at(1));
-			addr_vec.emplace_back(ring.at(2));
-		}
-		else {
-			// go through the ring until pos <= node
-			for (int i=1; i<ring.size(); i++){
-				Node addr = ring.at(i);
-				if (pos <= addr.getHashCode()) {
-					addr_vec.emplace_back(addr);
-					addr_vec.emplace_back(ring.at((i+1)%ring.size()));
-					addr_vec.emplace_back(ring.at((i+2)%ring.size()));
-					break;
-				}
-			}
-		}
-	}
-	return addr_vec;
+ * DESCRIPTION: Find the replicas of the given key
+ * 				The returned span points into the placement and is only valid until the next
+ * 				lookup or membership change
+ */
+ReplicaSpan MP2Node::findNodes(const string &key) {
+	return ring->replicasOf(hashFunction(key));
 }
 
 /**
@@ -421,39 +539,190 @@ int MP2Node::enqueueWrapper(void *env, char *buff, int size) {
  * FUNCTION NAME: stabilizationProtocol
  *
  * DESCRIPTION: This runs the stabilization protocol in case of Node joins and leaves
- * 				It ensures that there always 3 copies of all keys in the DHT at all times
+ * 				It ensures that there always REPLICATION_FACTOR copies of all keys in the DHT at all times
  * 				The function does the following:
- *				1) Ensures that there are three "CORRECT" replicas of all the keys in spite of failures and joins
+ *				1) Ensures that there are REPLICATION_FACTOR "CORRECT" replicas of all the keys in spite of failures and joins
  *				Note:- "CORRECT" replicas implies that every key is replicated in its two neighboring nodes in the ring
+ *				2) Rebuilds the Merkle trees of the key ranges this node is a replica of, the ranges change with the ring
+ *				3) Hands the keys this node is no longer a replica of to the replicas that were not replicas
+ *				   of the key before the ring changed, and drops them. The replicas that already were get
+ *				   any version they miss from the Merkle exchange between the new replicas.
+ *				4) Sends the roots of its trees to the other replicas of its ranges. Only the keys of the leaves
+ *				   that differ are exchanged afterwards, so the traffic follows the divergence between the
+ *				   replicas, not the number of keys
+ *				The entries are sent with their timestamp, a replica that has a newer version keeps it
  */
 void MP2Node::stabilizationProtocol() {
-	map<string, string>::iterator it = ht->hashTable.begin();
-	while(it != ht->hashTable.end()) {
-		string key = it->first;
-		string value = it->second;
-		vector<Node> replicas = findNodes(key);
-		Message message(STABLE, memberNode->addr, MessageType::CREATE, key, value);
-		for(int i=0; i<replicas.size(); ++i){
-			emulNet->ENsend(&memberNode->addr, replicas[i].getAddress(), message.toString());
+	antiEntropy.clear();
+	vector<string> handedOff;
+	ht->forEach([this, &handedOff](StringRef keyBytes, StringRef valueBytes) {
+		string key = keyBytes.str();
+		Entry entry(valueBytes.str());
+		uint64_t position = hashFunction(key);
+		ReplicaSpan replicas = ring->replicasOf(position);
+		if(replicas.empty())
+			return;
+		if(replicaIndex(replicas, &memberNode->addr) >= 0) {
+			antiEntropy.toggle(replicas, key, entry);
+			return;
 		}
-		++it;
+		// Without this node among the previous replicas nothing is known of who holds the key
+		ReplicaSpan previous = previousRing->replicasOf(position);
+		bool wasReplica = replicaIndex(previous, &memberNode->addr) >= 0;
+		for(size_t i=0; i<replicas.size(); ++i){
+			if(!wasReplica || replicaIndex(previous, replicas[i]) < 0)
+				sendEntry(replicas[i], key, entry, static_cast<ReplicaType>(min(i, (size_t)TERTIARY)));
+		}
+		handedOff.push_back(key);
+		if(entry.deleted)
+			--tombstoneCount;
+	});
+	for(size_t i=0; i<handedOff.size(); ++i){
+		ht->deleteKey(handedOff[i]);
+	}
+	vector<Address> peers;
+	antiEntropy.peers(memberNode->addr, peers);
+	for(size_t i=0; i<peers.size(); ++i){
+		sendRoots(&peers[i]);
+	}
+}
+
+/**
+ * FUNCTION NAME: sendRoots
+ *
+ * DESCRIPTION: Send the roots of the trees of the ranges the peer is a replica of,
+ * 				as "range:root" pairs, split over as many SYNCROOTS messages as needed
+ */
+void MP2Node::sendRoots(Address *peer) {
+	vector<uint64_t> ranges;
+	antiEntropy.rangesWith(*peer, ranges);
+	size_t limit = par->MAX_MSG_SIZE - 1 - sizeof(en_msg) - 64;
+	string roots;
+	for(size_t i=0; i<ranges.size(); ++i){
+		string item = to_string(ranges[i]) + ":" + to_string(antiEntropy.tree(ranges[i]).root());
+		if(!roots.empty() && roots.size() + 1 + item.size() > limit) {
+			Message message(STABLE, memberNode->addr, MessageType::SYNCROOTS, "", roots);
+			emulNet->ENsend(&memberNode->addr, peer, message.toString());
+			roots.clear();
+		}
+		if(!roots.empty())
+			roots += ",";
+		roots += item;
 	}
+	if(!roots.empty()) {
+		Message message(STABLE, memberNode->addr, MessageType::SYNCROOTS, "", roots);
+		emulNet->ENsend(&memberNode->addr, peer, message.toString());
+	}
+}
+
+/**
+ * FUNCTION NAME: handleSync
+ *
+ * DESCRIPTION: A peer sent the roots of the ranges we share. For every root that differs from ours,
+ * 				reply with our leaves of the range. A range both peers have keys of is driven by the
+ * 				one with the lower address, so it is only compared once.
+ */
+void MP2Node::handleSync(Message &message) {
+	const char *p = message.value.c_str();
+	char *end;
+	while(*p) {
+		uint64_t range = strtoull(p, &end, 10);
+		uint64_t root = strtoull(end + 1, &end, 10);
+		p = *end ? end + 1 : end;
+		if(antiEntropy.contains(range) && AntiEntropy::compare(memberNode->addr, message.fromAddr) < 0)
+			continue;
+		const MerkleTree &tree = antiEntropy.tree(range);
+		if(tree.root() == root)
+			continue;
+		string leaves;
+		for(size_t i=0; i<MERKLE_LEAVES; ++i){
+			if(i)
+				leaves += ",";
+			leaves += to_string(tree.leaf(i));
+		}
+		Message reply(STABLE, memberNode->addr, MessageType::SYNCLEAVES, to_string(range), leaves);
+		emulNet->ENsend(&memberNode->addr, &message.fromAddr, reply.toString());
+	}
+}
+
+/**
+ * FUNCTION NAME: handleSyncLeaves
+ *
+ * DESCRIPTION: A peer sent its leaves of a range whose root differs from ours. Stream our keys of
+ * 				the differing leaves to the peer, and ask it for its keys of the differing leaves
+ * 				it is not empty in. Leaves are sent as a mask, one bit per leaf.
+ */
+void MP2Node::handleSyncLeaves(Message &message) {
+	uint64_t range = stoull(message.key);
+	const MerkleTree &tree = antiEntropy.tree(range);
+	uint64_t push = 0;
+	uint64_t pull = 0;
+	const char *p = message.value.c_str();
+	char *end;
+	for(size_t i=0; i<MERKLE_LEAVES && *p; ++i){
+		uint64_t leaf = strtoull(p, &end, 10);
+		p = *end ? end + 1 : end;
+		if(leaf == tree.leaf(i))
+			continue;
+		if(tree.leaf(i) != 0)
+			push |= 1ULL << i;
+		if(leaf != 0)
+			pull |= 1ULL << i;
+	}
+	if(push)
+		streamKeys(&message.fromAddr, range, push);
+	if(pull) {
+		Message request(STABLE, memberNode->addr, MessageType::SYNCPULL, to_string(range), to_string(pull));
+		emulNet->ENsend(&memberNode->addr, &message.fromAddr, request.toString());
+	}
+}
+
+/**
+ * FUNCTION NAME: handleSyncPull
+ *
+ * DESCRIPTION: A peer asked for our keys of some leaves of a range
+ */
+void MP2Node::handleSyncPull(Message &message) {
+	streamKeys(&message.fromAddr, stoull(message.key), stoull(message.value));
+}
+
+/**
+ * FUNCTION NAME: streamKeys
+ *
+ * DESCRIPTION: Send the keys of the given leaves of the range to the peer, as stabilization creates
+ */
+void MP2Node::streamKeys(Address *peer, uint64_t range, uint64_t leaves) {
+	ht->forEach([this, peer, range, leaves](StringRef keyBytes, StringRef valueBytes) {
+		if(!(leaves >> MerkleTree::leafOf(hash64(keyBytes.data, keyBytes.size)) & 1))
+			return;
+		string key = keyBytes.str();
+		ReplicaSpan replicas = findNodes(key);
+		int index = replicaIndex(replicas, peer);
+		if(index < 0 || AntiEntropy::rangeOf(replicas) != range)
+			return;
+		sendEntry(peer, key, Entry(valueBytes.str()), static_cast<ReplicaType>(min(index, (int)TERTIARY)));
+	});
 }
 
 Message MP2Node::createMessage(MessageType type, string key, string value, bool success) {
-	createTransaction(g_transID, type, key, value);
+	uint64_t timestamp = (type == READ) ? 0 : clock.now(par->getcurrtime());
+	createTransaction(g_transID, type, key, value, timestamp);
 	if(type == CREATE || type == UPDATE){
-		Message msg(g_transID, memberNode->addr, type, key, value);
+		Message msg(g_transID, memberNode->addr, type, key, value, PRIMARY, timestamp);
 		return msg;
 	} else if(type == READ || type == DELETE){
 		Message msg(g_transID, memberNode->addr, type, key);
+		msg.timestamp = timestamp;
 		return msg;
 	}
 	return Message("");
 }
 
-void MP2Node::createTransaction(int transactionID, MessageType type, string key, string value) {
-	Transaction* transaction = new Transaction(transactionID, type, key, value, par->getcurrtime());
+void MP2Node::createTransaction(int transactionID, MessageType type, string key, string value, uint64_t version) {
+	int quorum = (type == READ) ? par->READ_QUORUM : par->WRITE_QUORUM;
+	Transaction* transaction = new Transaction(transactionID, type, key, value, par->getcurrtime(), quorum);
+	transaction->version = version;
+	transaction->replicas = findNodes(key).size();
 	transactionMap.emplace(transactionID, transaction);
 }
 
@@ -464,29 +733,42 @@ void MP2Node::checkTransactionMap() {
 		Transaction* transaction = it->second;
 		int replyCount = transaction->replyCount;
 		int successCount = transaction->successCount;
+		bool timedOut = par->getcurrtime() - transaction->getTimestamp() > 10;
 
-		if(replyCount == 3) {
-			(successCount >= 2) ? logOperation(transaction, true, true, transactionID) : logOperation(transaction, true, false, transactionID);
-			delete transaction;
-			it = transactionMap.erase(it);
-			continue;
-		} else {
-			if(successCount == 2) {
-				logOperation(transaction, true, true, transactionID);
-				transactionState.emplace(transactionID, true);
-				delete transaction;
-				it = transactionMap.erase(it);
-				continue;
-			} 
-			if(replyCount - successCount == 2) {
-				logOperation(transaction, true, false, transactionID);
-				transactionState.emplace(transactionID, false);
+		// A decided read only waits for the late replies, to repair them
+		if(transaction->decided) {
+			if(replyCount >= transaction->replicas || timedOut) {
 				delete transaction;
 				it = transactionMap.erase(it);
 				continue;
 			}
+			++it;
+			continue;
+		}
+		// Succeeds once quorum replicas agree, fails once too many of the replicas it was sent to refused for that to happen
+		if(successCount >= transaction->quorum) {
+			logOperation(transaction, true, true, transactionID);
+			transactionState.emplace(transactionID, true);
+			if(transaction->msgType == READ) {
+				readRepair(transaction);
+				if(replyCount < transaction->replicas) {
+					transaction->decided = true;
+					++it;
+					continue;
+				}
+			}
+			delete transaction;
+			it = transactionMap.erase(it);
+			continue;
 		}
-		if(par->getcurrtime() - transaction->getTimestamp() > 10) {
+		if(replyCount - successCount > transaction->replicas - transaction->quorum) {
+			logOperation(transaction, true, false, transactionID);
+			transactionState.emplace(transactionID, false);
+			delete transaction;
+			it = transactionMap.erase(it);
+			continue;
+		}
+		if(timedOut) {
 			logOperation(transaction, true, false, transactionID);
 			transactionState.emplace(transactionID, false);
 			delete transaction;
@@ -497,9 +779,52 @@ void MP2Node::checkTransactionMap() {
 	}
 }
 
-void MP2Node::sendReply(Address* fromAddr, int transactionID, bool success, MessageType type, string key, string content) {
+/**
+ * FUNCTION NAME: readRepair
+ *
+ * DESCRIPTION: Push the value a successful read returned to the replicas that replied with an
+ * 				older version or without the key. The repair is a stabilization create: the replica
+ * 				keeps whichever version is newer and does not reply. Replicas that no longer own
+ * 				the key are skipped.
+ */
+void MP2Node::readRepair(Transaction* transaction) {
+	Entry newest(transaction->value, transaction->version, PRIMARY);
+	ReplicaSpan owners = findNodes(transaction->key);
+	for(size_t i=0; i<transaction->replies.size(); ++i){
+		Address &replica = transaction->replies[i].first;
+		Entry &reply = transaction->replies[i].second;
+		if(!newest.newerThan(reply))
+			continue;
+		reply = newest;
+		for(size_t j=0; j<owners.size(); ++j){
+			if(*owners[j] == replica) {
+				sendEntry(&replica, transaction->key, newest, static_cast<ReplicaType>(min(j, (size_t)TERTIARY)));
+				break;
+			}
+		}
+	}
+}
+
+/**
+ * FUNCTION NAME: sendEntry
+ *
+ * DESCRIPTION: Send a stored entry to a replica of its key as a stabilization write:
+ * 				a delete for a tombstone, a create otherwise. The replica keeps the newer version.
+ */
+void MP2Node::sendEntry(Address *to, const string &key, const Entry &entry, ReplicaType replica) {
+	if(entry.deleted) {
+		Message message(STABLE, memberNode->addr, MessageType::DELETE, key);
+		message.timestamp = entry.timestamp;
+		emulNet->ENsend(&memberNode->addr, to, message.toString());
+	} else {
+		Message message(STABLE, memberNode->addr, MessageType::CREATE, key, entry.value, replica, entry.timestamp);
+		emulNet->ENsend(&memberNode->addr, to, message.toString());
+	}
+}
+
+void MP2Node::sendReply(Address* fromAddr, int transactionID, bool success, MessageType type, string key, string content, uint64_t timestamp) {
 	if(type == READ) {
-		Message message(transactionID, memberNode->addr, content);
+		Message message(transactionID, memberNode->addr, content, timestamp);
 		emulNet->ENsend(&memberNode->addr, fromAddr, message.toString());
 	} else {
 		Message message(transactionID, memberNode->addr, MessageType::REPLY, success);
@@ -540,5 +865,8 @@ void MP2Node::logOperation(Transaction* transaction, bool isCoordinator, bool su
 				log->logDeleteFail(&memberNode->addr, isCoordinator, transactionID, key);
 			break;
 		}
+		// Replies and anti-entropy messages never start a transaction
+		default:
+			break;
 	}
 }
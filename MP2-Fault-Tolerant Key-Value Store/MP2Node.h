@@ -13,12 +13,20 @@
 #include "stdincludes.h"
 #include "EmulNet.h"
 #include "Node.h"
+#include "Placement.h"
 #include "HashTable.h"
+#include "Entry.h"
+#include "HybridClock.h"
+#include "AntiEntropy.h"
 #include "Log.h"
 #include "Params.h"
 #include "Message.h"
 #include "Queue.h"
+#include "MembershipListener.h"
+#include "AggregateSource.h"
 #define STABLE -1
+// Ticks a delete tombstone is kept, long enough for read repair and anti-entropy to spread it
+#define TDELETE 100
 
 /**
  * CLASS NAME: Transaction
@@ -26,7 +34,11 @@
  * DESCRIPTION: This class encapsulates all transaction details:
  * 				1) ID
  * 				2) Timestamp
- * 				3) Reply and Success count
+ * 				3) Reply and Success count, and the quorum they are checked against
+ * 				4) Timestamp of the value, for writes the version written and for reads
+ * 				   the newest version replied so far
+ * 				5) For reads, the entry every replica replied with, to repair the stale ones.
+ * 				   A read is kept after it is decided until all its replicas replied or it times out.
  */
 class Transaction {
 private:
@@ -39,7 +51,15 @@ public:
 	MessageType msgType;
 	int replyCount;
 	int successCount;
-	Transaction(int transactionID, MessageType type, string key, string value, int timestamp);
+	// Successful replies the operation needs
+	int quorum;
+	uint64_t version;
+	// Replicas the request was sent to
+	int replicas;
+	// Set once the outcome was logged
+	bool decided;
+	vector<pair<Address, Entry> > replies;
+	Transaction(int transactionID, MessageType type, string key, string value, int timestamp, int quorum);
 	int getTimestamp() {
 		return timestamp;
 	}
@@ -52,20 +72,37 @@ public:
  * DESCRIPTION: This class encapsulates all the key-value store functionality
  * 				including:
  * 				1) Ring
- * 				2) Stabilization Protocol
+ * 				2) Stabilization Protocol, Merkle tree anti-entropy between the replicas of a key range
  * 				3) Server side CRUD APIs
  * 				4) Client side CRUD APIs
+ * 				The ring is patched from the membership change events of MP1Node,
+ * 				and its load counters are aggregated over the cluster by MP1Node.
  */
-class MP2Node {
+class MP2Node : public MembershipListener, public AggregateSource {
 private:
 	// Vector holding the next two neighbors in the ring who have my replicas
 	vector<Node> hasMyReplicas;
 	// Vector holding the previous two neighbors in the ring whose replicas I have
 	vector<Node> haveReplicasOf;
-	// Ring
-	vector<Node> ring;
-	// Hash Table
+	// Ring, the placement of the keys on the members
+	Placement *ring;
+	// Set when the ring was patched since the last updateRing
+	bool ringChanged;
+	// Ring as of the last stabilization, and the members added (true) or removed (false) since
+	Placement *previousRing;
+	vector<pair<Address, bool> > ringChanges;
+	// Messages handled and client requests coordinated so far
+	long handledMessages;
+	long servedRequests;
+	// Hash Table, the values are stored as serialized Entry objects
 	HashTable * ht;
+	// Clock the writes this node coordinates are stamped with
+	HybridClock clock;
+	// Merkle trees of the key ranges this node is a replica of
+	AntiEntropy antiEntropy;
+	// Delete tombstones by timestamp, oldest first, and the number stored
+	priority_queue<pair<uint64_t, string>, vector<pair<uint64_t, string> >, greater<pair<uint64_t, string> > > tombstones;
+	long tombstoneCount;
 	// Member representing this member
 	Member *memberNode;
 	// Params object
@@ -87,9 +124,15 @@ public:
 
 	// ring functionalities
 	void updateRing();
-	vector<Node> getMembershipList();
-	size_t hashFunction(string key);
+	uint64_t hashFunction(const string &key);
 	void findNeighbors();
+	void memberJoined(Address *addr, long version);
+	void memberLeft(Address *addr, long version);
+
+	// counters aggregated by MP1Node
+	long messagesHandled();
+	long requestsServed();
+	long keysStored();
 
 	// client side CRUD APIs
 	void clientCreate(string key, string value);
@@ -108,21 +151,32 @@ public:
 	void dispatchMessages(Message message);
 
 	// find the addresses of nodes that are responsible for a key
-	vector<Node> findNodes(string key);
+	ReplicaSpan findNodes(const string &key);
 
 	// server
-	bool createKeyValue(string key, string value, ReplicaType replica, int transactionID);
-	string readKey(string key, int transactionID);
-	bool updateKeyValue(string key, string value, ReplicaType replica, int transactionID);
-	bool deletekey(string key, int transactionID);
+	bool createKeyValue(string key, string value, ReplicaType replica, int transactionID, uint64_t timestamp);
+	Entry readKey(string key, int transactionID);
+	bool updateKeyValue(string key, string value, ReplicaType replica, int transactionID, uint64_t timestamp);
+	bool applyWrite(const string &key, const Entry &entry, bool create);
+	int replicaIndex(const ReplicaSpan &replicas, Address *addr);
+	void trackEntry(const string &key, const Entry &entry);
+	bool deletekey(string key, int transactionID, uint64_t timestamp);
+	void expireTombstones();
+	void sendEntry(Address *to, const string &key, const Entry &entry, ReplicaType replica);
 
 	// stabilization protocol - handle multiple failures
 	void stabilizationProtocol();
+	void sendRoots(Address *peer);
+	void handleSync(Message &message);
+	void handleSyncLeaves(Message &message);
+	void handleSyncPull(Message &message);
+	void streamKeys(Address *peer, uint64_t range, uint64_t leaves);
 
 	Message createMessage(MessageType type, string key, string value = "", bool success = false);
-	void createTransaction(int transactionID, MessageType type, string key, string value);
+	void createTransaction(int transactionID, MessageType type, string key, string value, uint64_t version);
 	void checkTransactionMap();
-	void sendReply(Address* fromAddr, int transactionID, bool success, MessageType type, string key, string content = "");
+	void readRepair(Transaction* transaction);
+	void sendReply(Address* fromAddr, int transactionID, bool success, MessageType type, string key, string content = "", uint64_t timestamp = 0);
 	void logOperation(Transaction* transaction, bool isCoordinator, bool success, int transactionID);
 
 	~MP2Node();
@@ -38,12 +38,12 @@ bool Address::operator ==(const Address& anotherAddress) {
 /**
  * Constructor
  */
-MemberListEntry::MemberListEntry(int id, short port, long heartbeat, long timestamp): id(id), port(port), heartbeat(heartbeat), timestamp(timestamp) {}
+MemberListEntry::MemberListEntry(int id, short port, long heartbeat, long timestamp): id(id), port(port), heartbeat(heartbeat), timestamp(timestamp), incarnation(0) {}
 
 /**
  * Constuctor
  */
-MemberListEntry::MemberListEntry(int id, short port): id(id), port(port) {}
+MemberListEntry::MemberListEntry(int id, short port): id(id), port(port), incarnation(0) {}
 
 /**
  * Copy constructor
@@ -53,6 +53,7 @@ MemberListEntry::MemberListEntry(const MemberListEntry &anotherMLE) {
 	this->id = anotherMLE.id;
 	this->port = anotherMLE.port;
 	this->timestamp = anotherMLE.timestamp;
+	this->incarnation = anotherMLE.incarnation;
 }
 
 /**
@@ -64,6 +65,7 @@ MemberListEntry& MemberListEntry::operator =(const MemberListEntry &anotherMLE)
 	swap(id, temp.id);
 	swap(port, temp.port);
 	swap(timestamp, temp.timestamp);
+	swap(incarnation, temp.incarnation);
 	return *this;
 }
 
@@ -103,6 +105,15 @@ long MemberListEntry::gettimestamp() {
 	return timestamp;
 }
 
+/**
+ * FUNCTION NAME: getincarnation
+ *
+ * DESCRIPTION: getter
+ */
+long MemberListEntry::getincarnation() {
+	return incarnation;
+}
+
 /**
  * FUNCTION NAME: setid
  *
@@ -139,6 +150,84 @@ void MemberListEntry::settimestamp(long timestamp) {
 	this->timestamp = timestamp;
 }
 
+/**
+ * FUNCTION NAME: setincarnation
+ *
+ * DESCRIPTION: setter
+ */
+void MemberListEntry::setincarnation(long incarnation) {
+	this->incarnation = incarnation;
+}
+
+/**
+ * FUNCTION NAME: at
+ *
+ * DESCRIPTION: return a copy of the entry at index
+ */
+MemberListEntry MembershipTable::at(size_t index) const {
+	MemberListEntry entry(ids[index], ports[index], heartbeats[index], timestamps[index]);
+	entry.incarnation = incarnations[index];
+	return entry;
+}
+
+/**
+ * FUNCTION NAME: push_back
+ *
+ * DESCRIPTION: append an entry to the table
+ */
+void MembershipTable::push_back(const MemberListEntry &entry) {
+	ids.push_back(entry.id);
+	ports.push_back(entry.port);
+	heartbeats.push_back(entry.heartbeat);
+	timestamps.push_back(entry.timestamp);
+	incarnations.push_back(entry.incarnation);
+}
+
+/**
+ * FUNCTION NAME: removeAt
+ *
+ * DESCRIPTION: remove the entry at index, the last entry takes its place
+ */
+void MembershipTable::removeAt(size_t index) {
+	size_t last = ids.size() - 1;
+	ids[index] = ids[last];
+	ports[index] = ports[last];
+	heartbeats[index] = heartbeats[last];
+	timestamps[index] = timestamps[last];
+	incarnations[index] = incarnations[last];
+	ids.pop_back();
+	ports.pop_back();
+	heartbeats.pop_back();
+	timestamps.pop_back();
+	incarnations.pop_back();
+}
+
+/**
+ * FUNCTION NAME: reserve
+ *
+ * DESCRIPTION: make room for capacity entries in every column
+ */
+void MembershipTable::reserve(size_t capacity) {
+	ids.reserve(capacity);
+	ports.reserve(capacity);
+	heartbeats.reserve(capacity);
+	timestamps.reserve(capacity);
+	incarnations.reserve(capacity);
+}
+
+/**
+ * FUNCTION NAME: clear
+ *
+ * DESCRIPTION: remove all entries
+ */
+void MembershipTable::clear() {
+	ids.clear();
+	ports.clear();
+	heartbeats.clear();
+	timestamps.clear();
+	incarnations.clear();
+}
+
 /**
  * Copy Constructor
  */
@@ -149,6 +238,7 @@ Member::Member(const Member &anotherMember) {
 	this->bFailed = anotherMember.bFailed;
 	this->nnb = anotherMember.nnb;
 	this->heartbeat = anotherMember.heartbeat;
+	this->incarnation = anotherMember.incarnation;
 	this->pingCounter = anotherMember.pingCounter;
 	this->timeOutCounter = anotherMember.timeOutCounter;
 	this->memberList = anotherMember.memberList;
@@ -167,6 +257,7 @@ Member& Member::operator =(const Member& anotherMember) {
 	this->bFailed = anotherMember.bFailed;
 	this->nnb = anotherMember.nnb;
 	this->heartbeat = anotherMember.heartbeat;
+	this->incarnation = anotherMember.incarnation;
 	this->pingCounter = anotherMember.pingCounter;
 	this->timeOutCounter = anotherMember.timeOutCounter;
 	this->memberList = anotherMember.memberList;
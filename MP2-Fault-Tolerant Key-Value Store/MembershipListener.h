@@ -0,0 +1,25 @@
+/**********************************
+ * FILE NAME: MembershipListener.h
+ *
+ * DESCRIPTION: Interface for the subscribers of membership change events
+ **********************************/
+
+#ifndef MEMBERSHIPLISTENER_H_
+#define MEMBERSHIPLISTENER_H_
+
+#include "Member.h"
+
+/**
+ * CLASS NAME: MembershipListener
+ *
+ * DESCRIPTION: Notified by MP1Node whenever a member is added to or removed from its memberList.
+ * 				version is the membership version after the change.
+ */
+class MembershipListener {
+public:
+	virtual void memberJoined(Address *addr, long version) = 0;
+	virtual void memberLeft(Address *addr, long version) = 0;
+	virtual ~MembershipListener() {}
+};
+
+#endif /* MEMBERSHIPLISTENER_H_ */
@@ -0,0 +1,53 @@
+/**********************************
+ * FILE NAME: MembershipSnapshot.h
+ *
+ * DESCRIPTION: Header file of the MembershipSnapshot class
+ **********************************/
+
+#ifndef MEMBERSHIPSNAPSHOT_H_
+#define MEMBERSHIPSNAPSHOT_H_
+
+#include "stdincludes.h"
+#include "Member.h"
+#include <stdint.h>
+
+#define SNAPSHOT_MAGIC "MP1SNAP"
+#define SNAPSHOT_VERSION 1
+
+/**
+ * STRUCT NAME: SnapshotHeader
+ *
+ * DESCRIPTION: Start of a snapshot file. It is followed by count entries stored column by column:
+ * 				heartbeats, timestamps and incarnations (int64), ids (int32), then ports (int16).
+ * 				Wider columns come first, so every column is naturally aligned in a mapped file.
+ */
+typedef struct SnapshotHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t count;
+	int64_t incarnation;
+	int64_t time;
+}SnapshotHeader;
+
+/**
+ * CLASS NAME: MembershipSnapshot
+ *
+ * DESCRIPTION: Writes the membership table of a node to a file, and maps it back in when the node restarts.
+ * 				A snapshot is written to a temporary file and renamed over the previous one, so a reader
+ * 				never sees a partly written snapshot.
+ */
+class MembershipSnapshot {
+private:
+	string path;
+	string temporaryPath;
+	// Snapshots are built here, it only grows with the table
+	vector<char> buffer;
+public:
+	MembershipSnapshot(const string &path);
+	void reserve(size_t entries);
+	bool write(MembershipTable &table, long incarnation, long time);
+	bool read(vector<MemberListEntry> &entries, long &incarnation, long &time);
+	void remove();
+};
+
+#endif /* MEMBERSHIPSNAPSHOT_H_ */
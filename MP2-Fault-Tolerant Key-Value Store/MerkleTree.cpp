@@ -0,0 +1,40 @@
+/**********************************
+ * FILE NAME: MerkleTree.cpp
+ *
+ * DESCRIPTION: Definition of the MerkleTree class
+ **********************************/
+
+#include "MerkleTree.h"
+
+/**
+ * Constructor
+ */
+MerkleTree::MerkleTree() {
+	memset(nodes, 0, sizeof(nodes));
+	for ( size_t i = MERKLE_LEAVES - 1; i >= 1; i-- ) {
+		nodes[i] = hash64(&nodes[2 * i], 2 * sizeof(uint64_t));
+	}
+}
+
+/**
+ * FUNCTION NAME: leafOf
+ *
+ * DESCRIPTION: Leaf of the key with the given hash. The hash is scrambled first: the keys of
+ * 				one range of the ring share the high bits of their position.
+ */
+size_t MerkleTree::leafOf(uint64_t keyHash) {
+	return mix64(keyHash) >> (64 - MERKLE_DEPTH);
+}
+
+/**
+ * FUNCTION NAME: toggle
+ *
+ * DESCRIPTION: Add the entry to the tree, or remove it if it is in it, and rehash the path to the root
+ */
+void MerkleTree::toggle(uint64_t keyHash, uint64_t entryHash) {
+	size_t i = MERKLE_LEAVES + leafOf(keyHash);
+	nodes[i] ^= entryHash;
+	for ( i /= 2; i >= 1; i /= 2 ) {
+		nodes[i] = hash64(&nodes[2 * i], 2 * sizeof(uint64_t));
+	}
+}
@@ -0,0 +1,42 @@
+/**********************************
+ * FILE NAME: MerkleTree.h
+ *
+ * DESCRIPTION: Header file of the MerkleTree class
+ **********************************/
+
+#ifndef MERKLETREE_H_
+#define MERKLETREE_H_
+
+#include "stdincludes.h"
+#include "Hash.h"
+
+// Levels below the root, the tree has 1 << MERKLE_DEPTH leaves
+#define MERKLE_DEPTH 6
+#define MERKLE_LEAVES (1 << MERKLE_DEPTH)
+
+/**
+ * CLASS NAME: MerkleTree
+ *
+ * DESCRIPTION: Hash tree over a set of entries. An entry falls into the leaf picked by the hash
+ * 				of its key, a leaf is the XOR of the hashes of its entries and an inner node the
+ * 				hash of its two children. Two replicas holding the same entries have the same root,
+ * 				and the leaves that differ tell which keys to exchange.
+ * 				Entries are toggled in and out in O(MERKLE_DEPTH), the tree is never rebuilt.
+ */
+class MerkleTree {
+private:
+	// Nodes in heap order: the root is at 1, the children of i at 2i and 2i+1
+	uint64_t nodes[2 * MERKLE_LEAVES];
+public:
+	MerkleTree();
+	static size_t leafOf(uint64_t keyHash);
+	void toggle(uint64_t keyHash, uint64_t entryHash);
+	uint64_t root() const {
+		return nodes[1];
+	}
+	uint64_t leaf(size_t i) const {
+		return nodes[MERKLE_LEAVES + i];
+	}
+};
+
+#endif /* MERKLETREE_H_ */
@@ -8,12 +8,15 @@
 /**
  * Constructor
  */
-// transID::fromAddr::CREATE::key::value::ReplicaType
+// transID::fromAddr::CREATE::key::value::ReplicaType::timestamp
 // transID::fromAddr::READ::key
-// transID::fromAddr::UPDATE::key::value::ReplicaType
-// transID::fromAddr::DELETE::key
+// transID::fromAddr::UPDATE::key::value::ReplicaType::timestamp
+// transID::fromAddr::DELETE::key::timestamp
 // transID::fromAddr::REPLY::sucess
-// transID::fromAddr::READREPLY::value
+// transID::fromAddr::READREPLY::value::timestamp
+// transID::fromAddr::SYNCROOTS::roots
+// transID::fromAddr::SYNCLEAVES::range::leaves
+// transID::fromAddr::SYNCPULL::range::leaves
 Message::Message(string message){
 	this->delimiter = "::";
 	vector<string> tuple;
@@ -27,6 +30,9 @@ Message::Message(string message){
 	}
 	tuple.push_back(message.substr(start));
 
+	replica = PRIMARY;
+	success = false;
+	timestamp = 0;
 	transID = stoi(tuple.at(0));
 	Address addr(tuple.at(1));
 	fromAddr = addr;
@@ -38,10 +44,16 @@ Message::Message(string message){
 			value = tuple.at(4);
 			if (tuple.size() > 5)
 				replica = static_cast<ReplicaType>(stoi(tuple.at(5)));
+			if (tuple.size() > 6)
+				timestamp = stoull(tuple.at(6));
 			break;
 		case READ:
+			key = tuple.at(3);
+			break;
 		case DELETE:
 			key = tuple.at(3);
+			if (tuple.size() > 4)
+				timestamp = stoull(tuple.at(4));
 			break;
 		case REPLY:
 			if (tuple.at(3) == "1")
@@ -51,6 +63,16 @@ Message::Message(string message){
 			break;
 		case READREPLY:
 			value = tuple.at(3);
+			if (tuple.size() > 4)
+				timestamp = stoull(tuple.at(4));
+			break;
+		case SYNCROOTS:
+			value = tuple.at(3);
+			break;
+		case SYNCLEAVES:
+		case SYNCPULL:
+			key = tuple.at(3);
+			value = tuple.at(4);
 			break;
 	}
 }
@@ -59,7 +81,7 @@ Message::Message(string message){
  * Constructor
  */
 // construct a create or update message
-Message::Message(int _transID, Address _fromAddr, MessageType _type, string _key, string _value, ReplicaType _replica){
+Message::Message(int _transID, Address _fromAddr, MessageType _type, string _key, string _value, ReplicaType _replica, uint64_t _timestamp){
 	this->delimiter = "::";
 	transID = _transID;
 	fromAddr = _fromAddr;
@@ -67,6 +89,8 @@ Message::Message(int _transID, Address _fromAddr, MessageType _type, string _key
 	key = _key;
 	value = _value;
 	replica = _replica;
+	success = false;
+	timestamp = _timestamp;
 }
 
 /**
@@ -81,6 +105,7 @@ Message::Message(const Message& anotherMessage) {
 	this->transID = anotherMessage.transID;
 	this->type = anotherMessage.type;
 	this->value = anotherMessage.value;
+	this->timestamp = anotherMessage.timestamp;
 }
 
 /**
@@ -93,6 +118,9 @@ Message::Message(int _transID, Address _fromAddr, MessageType _type, string _key
 	type = _type;
 	key = _key;
 	value = _value;
+	replica = PRIMARY;
+	success = false;
+	timestamp = 0;
 }
 
 /**
@@ -105,6 +133,9 @@ Message::Message(int _transID, Address _fromAddr, MessageType _type, string _key
 	fromAddr = _fromAddr;
 	type = _type;
 	key = _key;
+	replica = PRIMARY;
+	success = false;
+	timestamp = 0;
 }
 
 /**
@@ -117,18 +148,23 @@ Message::Message(int _transID, Address _fromAddr, MessageType _type, bool _succe
 	fromAddr = _fromAddr;
 	type = _type;
 	success = _success;
+	replica = PRIMARY;
+	timestamp = 0;
 }
 
 /**
  * Constructor
  */
 // construct read reply message
-Message::Message(int _transID, Address _fromAddr, string _value){
+Message::Message(int _transID, Address _fromAddr, string _value, uint64_t _timestamp){
 	this->delimiter = "::";
 	transID = _transID;
 	fromAddr = _fromAddr;
 	type = READREPLY;
 	value = _value;
+	replica = PRIMARY;
+	success = false;
+	timestamp = _timestamp;
 }
 
 /**
@@ -141,12 +177,14 @@ string Message::toString(){
 	switch(type){
 		case CREATE:
 		case UPDATE:
-			message += key + delimiter + value + delimiter + to_string(replica);
+			message += key + delimiter + value + delimiter + to_string(replica) + delimiter + to_string(timestamp);
 			break;
 		case READ:
-		case DELETE:
 			message += key;
 			break;
+		case DELETE:
+			message += key + delimiter + to_string(timestamp);
+			break;
 		case REPLY:
 			if (success)
 				message += "1";
@@ -154,8 +192,15 @@ string Message::toString(){
 				message += "0";
 			break;
 		case READREPLY:
+			message += value + delimiter + to_string(timestamp);
+			break;
+		case SYNCROOTS:
 			message += value;
 			break;
+		case SYNCLEAVES:
+		case SYNCPULL:
+			message += key + delimiter + value;
+			break;
 	}
 	return message;
 }
@@ -172,5 +217,6 @@ Message& Message::operator =(const Message& anotherMessage) {
 	this->transID = anotherMessage.transID;
 	this->type = anotherMessage.type;
 	this->value = anotherMessage.value;
+	this->timestamp = anotherMessage.timestamp;
 	return *this;
 }
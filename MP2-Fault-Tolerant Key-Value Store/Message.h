@@ -24,6 +24,8 @@ public:
 	Address fromAddr;
 	int transID;
 	bool success; // success or not 
+	// hybrid logical clock of the value carried by a create, update, delete or read reply, 0 if none
+	uint64_t timestamp;
 	// delimiter
 	string delimiter;
 	// construct a message from a string
@@ -31,13 +33,13 @@ public:
 	Message(const Message& anotherMessage);
 	// construct a create or update message
 	Message(int _transID, Address _fromAddr, MessageType _type, string _key, string _value);
-	Message(int _transID, Address _fromAddr, MessageType _type, string _key, string _value, ReplicaType _replica);
+	Message(int _transID, Address _fromAddr, MessageType _type, string _key, string _value, ReplicaType _replica, uint64_t _timestamp = 0);
 	// construct a read or delete message
 	Message(int _transID, Address _fromAddr, MessageType _type, string _key);
 	// construct reply message
 	Message(int _transID, Address _fromAddr, MessageType _type, bool _success);
 	// construct read reply message
-	Message(int _transID, Address _fromAddr, string _value);
+	Message(int _transID, Address _fromAddr, string _value, uint64_t _timestamp = 0);
 	Message& operator = (const Message& anotherMessage);
 	// serialize to a string
 	string toString();
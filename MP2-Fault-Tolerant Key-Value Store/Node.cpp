@@ -27,10 +27,21 @@ Node::~Node() {}
 /**
  * FUNCTION NAME: computeHashCode
  *
- * DESCRIPTION: This function computes the hash code of the node address
+ * DESCRIPTION: This function computes the hash code of the node address, its position on the ring.
+ * 				All the bytes of the binary address are hashed.
  */
 void Node::computeHashCode() {
-	nodeHashCode = hashFunc(nodeAddress.addr)%RING_SIZE;
+	nodeHashCode = hash64(nodeAddress.addr, sizeof(nodeAddress.addr));
+}
+
+/**
+ * FUNCTION NAME: computeHashCode
+ *
+ * DESCRIPTION: This function computes the position of the given virtual token of the node.
+ * 				The token seeds the hash of the address, token 0 is the position of the node itself.
+ */
+void Node::computeHashCode(int token) {
+	nodeHashCode = hash64(nodeAddress.addr, sizeof(nodeAddress.addr), token);
 }
 
 /**
@@ -62,7 +73,7 @@ bool Node::operator < (const Node& another) const {
  *
  * DESCRIPTION: return hash code of the node
  */
-size_t Node::getHashCode() {
+uint64_t Node::getHashCode() {
 	return nodeHashCode;
 }
 
@@ -80,7 +91,7 @@ Address * Node::getAddress() {
  *
  * DESCRIPTION: set the hash code of the node
  */
-void Node::setHashCode(size_t hashCode) {
+void Node::setHashCode(uint64_t hashCode) {
 	this->nodeHashCode = hashCode;
 }
 
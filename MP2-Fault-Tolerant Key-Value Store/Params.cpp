@@ -18,32 +18,137 @@ Params::Params(): PORTNUM(8001) {}
  */
 void Params::setparams(char *config_file) {
 	//trace.funcEntry("Params::setparams");
-	char CRUD[10];
+	char key[64];
+	char value[64];
 	FILE *fp = fopen(config_file,"r");
 
-	fscanf(fp,"MAX_NNB: %d", &MAX_NNB);
-	fscanf(fp,"\nSINGLE_FAILURE: %d", &SINGLE_FAILURE);
-	fscanf(fp,"\nDROP_MSG: %d", &DROP_MSG);
-	fscanf(fp,"\nMSG_DROP_PROB: %lf", &MSG_DROP_PROB);
-	fscanf(fp,"\nCRUD_TEST: %s", CRUD);
+	// Defaults for the keys a test case may leave out
+	MAX_NNB = 10;
+	SINGLE_FAILURE = 0;
+	DROP_MSG = 0;
+	MSG_DROP_PROB = 0;
+	PHI_THRESHOLD = 0;
+	GRACEFUL_LEAVE = 0;
+	INTRODUCERS = 1;
+	GOSSIP_ENTRIES = 0;
+	SNAPSHOT_INTERVAL = 0;
+	RESTART_AFTER = 0;
+	STEP_RATE = .25;
+	ZONES = 1;
+	HIERARCHICAL = 0;
+	CROSS_ZONE_INTERVAL = 2;
+	INTRA_ZONE_LATENCY = 0;
+	CROSS_ZONE_LATENCY = 0;
+	BROADCASTS = 0;
+	VNODES = 1;
+	PLACEMENT = CONSISTENT_PLACEMENT;
+	LOAD_FACTOR = 1.25;
+	REPLICATION_FACTOR = 3;
+	READ_QUORUM = 2;
+	WRITE_QUORUM = 2;
+	CRUDTEST = CREATE_TEST;
 
-	if ( 0 == strcmp(CRUD, "CREATE") ) {
-		this->CRUDTEST = CREATE_TEST;
-	}
-	else if ( 0 == strcmp(CRUD, "READ") ) {
-		this->CRUDTEST = READ_TEST;
-	}
-	else if ( 0 == strcmp(CRUD, "UPDATE") ) {
-		this->CRUDTEST = UPDATE_TEST;
-	}
-	else if ( 0 == strcmp(CRUD, "DELETE") ) {
-		this->CRUDTEST = DELETE_TEST;
+	// Every line of the test case is a "KEY: value" pair
+	while ( fscanf(fp, " %63[^:]: %63s", key, value) == 2 ) {
+		if ( 0 == strcmp(key, "MAX_NNB") ) {
+			MAX_NNB = atoi(value);
+		}
+		else if ( 0 == strcmp(key, "SINGLE_FAILURE") ) {
+			SINGLE_FAILURE = atoi(value);
+		}
+		else if ( 0 == strcmp(key, "DROP_MSG") ) {
+			DROP_MSG = atoi(value);
+		}
+		else if ( 0 == strcmp(key, "MSG_DROP_PROB") ) {
+			MSG_DROP_PROB = atof(value);
+		}
+		else if ( 0 == strcmp(key, "PHI_THRESHOLD") ) {
+			PHI_THRESHOLD = atof(value);
+		}
+		else if ( 0 == strcmp(key, "GRACEFUL_LEAVE") ) {
+			GRACEFUL_LEAVE = atoi(value);
+		}
+		else if ( 0 == strcmp(key, "INTRODUCERS") ) {
+			INTRODUCERS = atoi(value);
+		}
+		else if ( 0 == strcmp(key, "STEP_RATE") ) {
+			STEP_RATE = atof(value);
+		}
+		else if ( 0 == strcmp(key, "GOSSIP_ENTRIES") ) {
+			GOSSIP_ENTRIES = atoi(value);
+		}
+		else if ( 0 == strcmp(key, "SNAPSHOT_INTERVAL") ) {
+			SNAPSHOT_INTERVAL = atoi(value);
+		}
+		else if ( 0 == strcmp(key, "RESTART_AFTER") ) {
+			RESTART_AFTER = atoi(value);
+		}
+		else if ( 0 == strcmp(key, "ZONES") ) {
+			ZONES = atoi(value);
+		}
+		else if ( 0 == strcmp(key, "HIERARCHICAL") ) {
+			HIERARCHICAL = atoi(value);
+		}
+		else if ( 0 == strcmp(key, "CROSS_ZONE_INTERVAL") ) {
+			CROSS_ZONE_INTERVAL = atoi(value);
+		}
+		else if ( 0 == strcmp(key, "INTRA_ZONE_LATENCY") ) {
+			INTRA_ZONE_LATENCY = atoi(value);
+		}
+		else if ( 0 == strcmp(key, "CROSS_ZONE_LATENCY") ) {
+			CROSS_ZONE_LATENCY = atoi(value);
+		}
+		else if ( 0 == strcmp(key, "BROADCASTS") ) {
+			BROADCASTS = atoi(value);
+		}
+		else if ( 0 == strcmp(key, "VNODES") ) {
+			VNODES = atoi(value);
+		}
+		else if ( 0 == strcmp(key, "PLACEMENT") ) {
+			if ( 0 == strcmp(value, "CONSISTENT") ) {
+				PLACEMENT = CONSISTENT_PLACEMENT;
+			}
+			else if ( 0 == strcmp(value, "RENDEZVOUS") ) {
+				PLACEMENT = RENDEZVOUS_PLACEMENT;
+			}
+			else if ( 0 == strcmp(value, "JUMP") ) {
+				PLACEMENT = JUMP_PLACEMENT;
+			}
+			else if ( 0 == strcmp(value, "BOUNDED") ) {
+				PLACEMENT = BOUNDED_LOAD_PLACEMENT;
+			}
+		}
+		else if ( 0 == strcmp(key, "LOAD_FACTOR") ) {
+			LOAD_FACTOR = atof(value);
+		}
+		else if ( 0 == strcmp(key, "REPLICATION_FACTOR") ) {
+			REPLICATION_FACTOR = atoi(value);
+		}
+		else if ( 0 == strcmp(key, "READ_QUORUM") ) {
+			READ_QUORUM = atoi(value);
+		}
+		else if ( 0 == strcmp(key, "WRITE_QUORUM") ) {
+			WRITE_QUORUM = atoi(value);
+		}
+		else if ( 0 == strcmp(key, "CRUD_TEST") ) {
+			if ( 0 == strcmp(value, "CREATE") ) {
+				this->CRUDTEST = CREATE_TEST;
+			}
+			else if ( 0 == strcmp(value, "READ") ) {
+				this->CRUDTEST = READ_TEST;
+			}
+			else if ( 0 == strcmp(value, "UPDATE") ) {
+				this->CRUDTEST = UPDATE_TEST;
+			}
+			else if ( 0 == strcmp(value, "DELETE") ) {
+				this->CRUDTEST = DELETE_TEST;
+			}
+		}
 	}
 
 	//printf("Parameters of the test case: %d %d %d %lf\n", MAX_NNB, SINGLE_FAILURE, DROP_MSG, MSG_DROP_PROB);
 
 	EN_GPSZ = MAX_NNB;
-	STEP_RATE=.25;
 	MAX_MSG_SIZE = 4000;
 	globaltime = 0;
 	dropmsg = 0;
@@ -51,6 +156,13 @@ void Params::setparams(char *config_file) {
 	for ( unsigned int i = 0; i < EN_GPSZ; i++ ) {
 		allNodesJoined += i;
 	}
+	if ( CROSS_ZONE_INTERVAL < 1 ) {
+		CROSS_ZONE_INTERVAL = 1;
+	}
+	// Quorums are between 1 and N
+	REPLICATION_FACTOR = max(REPLICATION_FACTOR, 1);
+	READ_QUORUM = min(max(READ_QUORUM, 1), REPLICATION_FACTOR);
+	WRITE_QUORUM = min(max(WRITE_QUORUM, 1), REPLICATION_FACTOR);
 	fclose(fp);
 	//trace.funcExit("Params::setparams", SUCCESS);
 	return;
@@ -65,3 +177,25 @@ void Params::setparams(char *config_file) {
 int Params::getcurrtime(){
     return globaltime;
 }
+
+/**
+ * FUNCTION NAME: zoneOf
+ *
+ * DESCRIPTION: Return the zone of the node with the given id.
+ * 				Nodes are placed in ZONES racks of consecutive ids.
+ */
+int Params::zoneOf(int id) {
+	if ( ZONES <= 1 || EN_GPSZ <= 0 ) {
+		return 0;
+	}
+	return ((id - 1) % EN_GPSZ) * ZONES / EN_GPSZ;
+}
+
+/**
+ * FUNCTION NAME: linkLatency
+ *
+ * DESCRIPTION: Return the number of ticks a message takes from node id from to node id to
+ */
+int Params::linkLatency(int from, int to) {
+	return zoneOf(from) == zoneOf(to) ? INTRA_ZONE_LATENCY : CROSS_ZONE_LATENCY;
+}
@@ -0,0 +1,32 @@
+/**********************************
+ * FILE NAME: Placement.cpp
+ *
+ * DESCRIPTION: Factory of the key placement strategies
+ **********************************/
+
+#include "Placement.h"
+#include "Params.h"
+#include "Ring.h"
+#include "BoundedLoadRing.h"
+#include "RendezvousPlacement.h"
+#include "JumpPlacement.h"
+
+/**
+ * FUNCTION NAME: create
+ *
+ * DESCRIPTION: Returns a new placement of the given strategy, storing every key on replicas
+ * 				distinct members. tokensPerNode is used by the
+ * 				ring based strategies, loadFactor by the bounded-load ring.
+ */
+Placement *Placement::create(int strategy, size_t replicas, int tokensPerNode, double loadFactor) {
+	switch ( strategy ) {
+		case RENDEZVOUS_PLACEMENT:
+			return new RendezvousPlacement(replicas);
+		case JUMP_PLACEMENT:
+			return new JumpPlacement(replicas);
+		case BOUNDED_LOAD_PLACEMENT:
+			return new BoundedLoadRing(replicas, tokensPerNode, loadFactor);
+		default:
+			return new Ring(replicas, tokensPerNode);
+	}
+}
@@ -0,0 +1,71 @@
+/**********************************
+ * FILE NAME: Placement.h
+ *
+ * DESCRIPTION: Interface of the key placement strategies
+ **********************************/
+
+#ifndef PLACEMENT_H_
+#define PLACEMENT_H_
+
+#include "stdincludes.h"
+#include "Node.h"
+
+/**
+ * CLASS NAME: ReplicaSpan
+ *
+ * DESCRIPTION: Non-owning view of the preference list of a key, in replica order
+ * 				(PRIMARY, SECONDARY, TERTIARY). It stays valid until the next lookup or
+ * 				membership change of the placement it came from.
+ */
+class ReplicaSpan {
+private:
+	Address *first;
+	size_t count;
+public:
+	ReplicaSpan(Address *first, size_t count): first(first), count(count) {}
+	size_t size() const {
+		return count;
+	}
+	bool empty() const {
+		return count == 0;
+	}
+	Address *operator[](size_t i) const {
+		return first + i;
+	}
+	Address *begin() const {
+		return first;
+	}
+	Address *end() const {
+		return first + count;
+	}
+	// Owning copy, for callers that change the ring while holding on to the replicas
+	vector<Node> nodes() const {
+		return vector<Node>(begin(), end());
+	}
+};
+
+/**
+ * CLASS NAME: Placement
+ *
+ * DESCRIPTION: Maps the hash of a key to the distinct members that store its replicas.
+ * 				Every node keeps its own instance, fed with the membership changes of MP1Node,
+ * 				so the placement must only depend on the set of members, not on the order
+ * 				they were added in. Lookups return an empty span while there are fewer members
+ * 				than replicas.
+ */
+class Placement {
+protected:
+	// Number of replicas of every key
+	size_t replicas;
+public:
+	Placement(size_t replicas): replicas(replicas < 1 ? 1 : replicas) {}
+	virtual void insert(Address *addr) = 0;
+	virtual bool remove(Address *addr) = 0;
+	virtual size_t size() = 0;
+	virtual ReplicaSpan replicasOf(uint64_t position) = 0;
+	virtual ~Placement() {}
+	// Placement of the given placementTYPE
+	static Placement *create(int strategy, size_t replicas, int tokensPerNode, double loadFactor);
+};
+
+#endif /* PLACEMENT_H_ */
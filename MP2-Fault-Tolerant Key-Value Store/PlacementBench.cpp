@@ -0,0 +1,153 @@
+/**********************************
+ * FILE NAME: PlacementBench.cpp
+ *
+ * DESCRIPTION: Benchmark of the key placement strategies.
+ * 				For every strategy and cluster size, measures the cost of a lookup, the skew of
+ * 				the number of keys (replicas included) per member, and the fraction of the
+ * 				replicas that move when a member joins or leaves. The ideal fractions are
+ * 				1/(n+1) for a join and 1/n for a leave.
+ * 				Build and run with "make bench".
+ **********************************/
+
+#include "Placement.h"
+#include "Params.h"
+#include <chrono>
+
+#define BENCH_KEYS 1000000
+#define BENCH_ROUNDS 1
+#define BENCH_REPLICAS 3
+#define BENCH_TOKENS 64
+#define BENCH_LOAD_FACTOR 1.1
+
+struct Strategy {
+	const char *name;
+	int type;
+	int tokens;
+};
+
+static const Strategy strategies[] = {
+	{ "consistent/1", CONSISTENT_PLACEMENT, 1 },
+	{ "consistent/64", CONSISTENT_PLACEMENT, BENCH_TOKENS },
+	{ "bounded/64", BOUNDED_LOAD_PLACEMENT, BENCH_TOKENS },
+	{ "rendezvous", RENDEZVOUS_PLACEMENT, 1 },
+	{ "jump", JUMP_PLACEMENT, 1 },
+};
+
+/**
+ * FUNCTION NAME: memberAddress
+ *
+ * DESCRIPTION: address of the member with the given id, as assigned by EmulNet
+ */
+static Address memberAddress(int id) {
+	return Address(to_string(id) + ":0");
+}
+
+/**
+ * FUNCTION NAME: memberId
+ *
+ * DESCRIPTION: id of the member at the given address
+ */
+static int memberId(Address *addr) {
+	int id;
+	memcpy(&id, &addr->addr[0], sizeof(int));
+	return id;
+}
+
+/**
+ * FUNCTION NAME: assign
+ *
+ * DESCRIPTION: ids of the replicas of every key, BENCH_REPLICAS per key
+ */
+static void assign(Placement *placement, const vector<uint64_t> &keys, vector<int> &ids) {
+	ids.resize(keys.size() * BENCH_REPLICAS);
+	for ( size_t k = 0; k < keys.size(); k++ ) {
+		ReplicaSpan replicas = placement->replicasOf(keys[k]);
+		for ( size_t r = 0; r < BENCH_REPLICAS; r++ ) {
+			ids[k * BENCH_REPLICAS + r] = memberId(replicas[r]);
+		}
+	}
+}
+
+/**
+ * FUNCTION NAME: moved
+ *
+ * DESCRIPTION: fraction of the replicas stored on a member that did not store them before
+ */
+static double moved(const vector<int> &before, const vector<int> &after) {
+	long count = 0;
+	for ( size_t k = 0; k < before.size(); k += BENCH_REPLICAS ) {
+		for ( size_t r = 0; r < BENCH_REPLICAS; r++ ) {
+			if ( find(&before[k], &before[k] + BENCH_REPLICAS, after[k + r]) == &before[k] + BENCH_REPLICAS ) {
+				count++;
+			}
+		}
+	}
+	return (double)count / before.size();
+}
+
+/**
+ * FUNCTION NAME: bench
+ *
+ * DESCRIPTION: measure one strategy over a cluster of the given size
+ */
+static void bench(const Strategy &strategy, int members, const vector<uint64_t> &keys) {
+	Placement *placement = Placement::create(strategy.type, BENCH_REPLICAS, strategy.tokens, BENCH_LOAD_FACTOR);
+	for ( int id = 1; id <= members; id++ ) {
+		Address addr = memberAddress(id);
+		placement->insert(&addr);
+	}
+
+	unsigned long checksum = 0;
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for ( int round = 0; round < BENCH_ROUNDS; round++ ) {
+		for ( size_t k = 0; k < keys.size(); k++ ) {
+			checksum += placement->replicasOf(keys[k])[0]->addr[0];
+		}
+	}
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	vector<int> before, after;
+	assign(placement, keys, before);
+	vector<long> load(members + 2, 0);
+	for ( size_t i = 0; i < before.size(); i++ ) {
+		load[before[i]]++;
+	}
+	double mean = (double)before.size() / members;
+	double sumSquares = 0;
+	long maxLoad = 0;
+	for ( int id = 1; id <= members; id++ ) {
+		sumSquares += (load[id] - mean) * (load[id] - mean);
+		maxLoad = max(maxLoad, load[id]);
+	}
+
+	Address joiner = memberAddress(members + 1);
+	placement->insert(&joiner);
+	assign(placement, keys, after);
+	double join = moved(before, after);
+	placement->remove(&joiner);
+
+	Address leaver = memberAddress(members / 2 + 1);
+	placement->remove(&leaver);
+	assign(placement, keys, after);
+	double leave = moved(before, after);
+
+	printf("%-14s %5d members  %8.1f ns/lookup  max/mean %5.2f  stddev/mean %5.3f  moved on join %6.4f (ideal %6.4f)  on leave %6.4f (ideal %6.4f)%s\n",
+		strategy.name, members, seconds * 1e9 / (BENCH_ROUNDS * keys.size()), maxLoad / mean, sqrt(sumSquares / members) / mean,
+		join, 1.0 / (members + 1), leave, 1.0 / members, checksum ? "" : " ");
+	delete placement;
+}
+
+int main() {
+	vector<uint64_t> keys(BENCH_KEYS);
+	for ( size_t k = 0; k < keys.size(); k++ ) {
+		string key = "key" + to_string(k);
+		keys[k] = hash64(key.data(), key.size());
+	}
+	int sizes[] = { 10, 100, 1000 };
+	for ( size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++ ) {
+		for ( size_t i = 0; i < sizeof(strategies) / sizeof(strategies[0]); i++ ) {
+			bench(strategies[i], sizes[s], keys);
+		}
+	}
+	return 0;
+}
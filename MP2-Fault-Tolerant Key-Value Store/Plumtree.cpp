@@ -0,0 +1,317 @@
+/**********************************
+ * FILE NAME: Plumtree.cpp
+ *
+ * DESCRIPTION: Definition of the Plumtree class
+ **********************************/
+
+#include "Plumtree.h"
+
+/**
+ * Constructor
+ */
+Plumtree::Plumtree(size_t capacity): capacity(capacity), seen(0), oldest(0), kept(0), payloadSize(0), missingCount(0) {}
+
+/**
+ * FUNCTION NAME: reserve
+ *
+ * DESCRIPTION: Make room for the links to a group of members, and for slots broadcasts of up to payloadSize
+ * 				bytes kept or missing at once, so that the broadcasts that follow are handled without allocating
+ */
+void Plumtree::reserve(size_t members, size_t slots, size_t payloadSize) {
+	this->payloadSize = payloadSize;
+	// Grafts take links into the tree beyond the capacity of the view, up to the whole group
+	eager.reserve(members);
+	lazy.reserve(capacity);
+	grow(slots);
+	announcements.reserve(slots);
+}
+
+/**
+ * FUNCTION NAME: grow
+ *
+ * DESCRIPTION: Grow the ring of kept broadcasts and the missing slots to at least slots each.
+ * 				The kept broadcasts are moved to the start of the ring.
+ */
+void Plumtree::grow(size_t slots) {
+	if ( messages.size() < slots ) {
+		rotate(messages.begin(), messages.begin() + oldest, messages.end());
+		oldest = 0;
+		size_t first = messages.size();
+		messages.resize(slots);
+		for ( size_t i = first; i < slots; i++ ) {
+			messages[i].payload.reserve(payloadSize);
+		}
+	}
+	if ( missing.size() < slots ) {
+		size_t first = missing.size();
+		missing.resize(slots);
+		for ( size_t i = first; i < slots; i++ ) {
+			missing[i].announcers.reserve(capacity);
+		}
+	}
+}
+
+/**
+ * FUNCTION NAME: erase
+ *
+ * DESCRIPTION: Remove the peer from the list, returns false if it was not in it
+ */
+bool Plumtree::erase(vector<unsigned long long> &peers, unsigned long long key) {
+	vector<unsigned long long>::iterator it = find(peers.begin(), peers.end(), key);
+	if ( it == peers.end() ) {
+		return false;
+	}
+	*it = peers.back();
+	peers.pop_back();
+	return true;
+}
+
+/**
+ * FUNCTION NAME: addPeer
+ *
+ * DESCRIPTION: Offer a new member to the view. The view keeps a uniform sample of the members
+ * 				offered so far (reservoir sampling), so every node ends up with different peers.
+ * 				Peers join the view as eager peers. Returns true if the member joined the view.
+ */
+bool Plumtree::addPeer(unsigned long long key) {
+	if ( inView(key) ) {
+		return false;
+	}
+	++seen;
+	if ( viewSize() < capacity ) {
+		eager.push_back(key);
+		return true;
+	}
+	if ( (size_t)(rand() % seen) >= capacity ) {
+		return false;
+	}
+	size_t victim = rand() % viewSize();
+	if ( victim < eager.size() ) {
+		erase(eager, eager[victim]);
+	}
+	else {
+		erase(lazy, lazy[victim - eager.size()]);
+	}
+	eager.push_back(key);
+	return true;
+}
+
+/**
+ * FUNCTION NAME: removePeer
+ *
+ * DESCRIPTION: Drop a member that left the group. Returns true if it was in the view.
+ */
+bool Plumtree::removePeer(unsigned long long key) {
+	return erase(eager, key) || erase(lazy, key);
+}
+
+/**
+ * FUNCTION NAME: inView
+ *
+ * DESCRIPTION: Returns true if the member is an eager or a lazy peer
+ */
+bool Plumtree::inView(unsigned long long key) {
+	return find(eager.begin(), eager.end(), key) != eager.end() || find(lazy.begin(), lazy.end(), key) != lazy.end();
+}
+
+/**
+ * FUNCTION NAME: viewSize
+ *
+ * DESCRIPTION: Number of eager and lazy peers
+ */
+size_t Plumtree::viewSize() {
+	return eager.size() + lazy.size();
+}
+
+/**
+ * FUNCTION NAME: graft
+ *
+ * DESCRIPTION: Make the link to the peer part of the tree. Peers that push or graft to us are
+ * 				taken into the view even when it is full, links are used in both directions.
+ */
+void Plumtree::graft(unsigned long long key) {
+	erase(lazy, key);
+	if ( find(eager.begin(), eager.end(), key) == eager.end() ) {
+		eager.push_back(key);
+	}
+}
+
+/**
+ * FUNCTION NAME: prune
+ *
+ * DESCRIPTION: Take the link to the peer out of the tree, it only carries announcements from now on.
+ * 				Links taken in by graft beyond the capacity of the view are dropped instead, so that
+ * 				announcements stay bounded by the view size.
+ */
+void Plumtree::prune(unsigned long long key) {
+	if ( !erase(eager, key) && find(lazy.begin(), lazy.end(), key) != lazy.end() ) {
+		return;
+	}
+	if ( viewSize() < capacity ) {
+		lazy.push_back(key);
+	}
+}
+
+/**
+ * FUNCTION NAME: eagerPeers
+ *
+ * DESCRIPTION: Peers broadcasts are pushed to
+ */
+const vector<unsigned long long>& Plumtree::eagerPeers() {
+	return eager;
+}
+
+/**
+ * FUNCTION NAME: lazyPeers
+ *
+ * DESCRIPTION: Peers broadcasts are announced to
+ */
+const vector<unsigned long long>& Plumtree::lazyPeers() {
+	return lazy;
+}
+
+/**
+ * FUNCTION NAME: store
+ *
+ * DESCRIPTION: Keep a broadcast until expires and queue its announcement. Every broadcast is kept
+ * 				for the same time, so expires never goes back from one call to the next.
+ * 				Returns false if it was received before, in which case it is a duplicate.
+ */
+bool Plumtree::store(unsigned long long id, int round, const char *payload, int size, long expires) {
+	if ( lookup(id) != NULL ) {
+		return false;
+	}
+	if ( kept == messages.size() ) {
+		grow(max((size_t) 1, 2 * messages.size()));
+	}
+	BroadcastMessage &message = messages[(oldest + kept) % messages.size()];
+	++kept;
+	message.id = id;
+	message.round = round;
+	message.payload.assign(payload, size);
+	message.expires = expires;
+	found(id);
+	announcements.push_back(id);
+	return true;
+}
+
+/**
+ * FUNCTION NAME: lookup
+ *
+ * DESCRIPTION: Returns the broadcast with the given id, NULL if it is unknown or expired
+ */
+const BroadcastMessage *Plumtree::lookup(unsigned long long id) {
+	for ( size_t i = 0; i < kept; i++ ) {
+		const BroadcastMessage &message = messages[(oldest + i) % messages.size()];
+		if ( message.id == id ) {
+			return &message;
+		}
+	}
+	return NULL;
+}
+
+/**
+ * FUNCTION NAME: announced
+ *
+ * DESCRIPTION: A peer announced a broadcast. If it has not arrived by deadline, the link to
+ * 				the first peer that announced it is grafted.
+ */
+void Plumtree::announced(unsigned long long id, unsigned long long from, long deadline) {
+	if ( lookup(id) != NULL ) {
+		return;
+	}
+	for ( size_t i = 0; i < missingCount; i++ ) {
+		if ( missing[i].id == id ) {
+			missing[i].announcers.push_back(from);
+			return;
+		}
+	}
+	if ( missingCount == missing.size() ) {
+		grow(max((size_t) 1, 2 * missing.size()));
+	}
+	Missing &entry = missing[missingCount++];
+	entry.id = id;
+	entry.announcers.clear();
+	entry.announcers.push_back(from);
+	entry.next = 0;
+	entry.deadline = deadline;
+}
+
+/**
+ * FUNCTION NAME: found
+ *
+ * DESCRIPTION: Stop waiting for the broadcast, it arrived
+ */
+void Plumtree::found(unsigned long long id) {
+	for ( size_t i = 0; i < missingCount; i++ ) {
+		if ( missing[i].id == id ) {
+			if ( i != --missingCount ) {
+				swap(missing[i], missing[missingCount]);
+			}
+			return;
+		}
+	}
+}
+
+/**
+ * FUNCTION NAME: timedOut
+ *
+ * DESCRIPTION: Collect the (broadcast, peer) pairs to graft: one announcer of every broadcast that
+ * 				is overdue. The next announcer is tried retry ticks later if it still does not arrive.
+ */
+void Plumtree::timedOut(long now, long retry, vector<pair<unsigned long long, unsigned long long> > &grafts) {
+	size_t i = 0;
+	while ( i < missingCount ) {
+		Missing &entry = missing[i];
+		if ( entry.deadline > now ) {
+			++i;
+			continue;
+		}
+		grafts.push_back(make_pair(entry.id, entry.announcers[entry.next++]));
+		entry.deadline = now + retry;
+		if ( entry.next == entry.announcers.size() ) {
+			if ( i != --missingCount ) {
+				swap(entry, missing[missingCount]);
+			}
+		}
+		else {
+			++i;
+		}
+	}
+}
+
+/**
+ * FUNCTION NAME: pendingAnnouncements
+ *
+ * DESCRIPTION: Broadcasts received since the last flush. The caller announces and clears them.
+ */
+vector<unsigned long long>& Plumtree::pendingAnnouncements() {
+	return announcements;
+}
+
+/**
+ * FUNCTION NAME: expire
+ *
+ * DESCRIPTION: Forget the broadcasts kept past their expiry time
+ */
+void Plumtree::expire(long now) {
+	while ( kept > 0 && messages[oldest].expires <= now ) {
+		oldest = (oldest + 1) % messages.size();
+		--kept;
+	}
+}
+
+/**
+ * FUNCTION NAME: clear
+ *
+ * DESCRIPTION: Forget the view and every broadcast
+ */
+void Plumtree::clear() {
+	seen = 0;
+	eager.clear();
+	lazy.clear();
+	oldest = 0;
+	kept = 0;
+	missingCount = 0;
+	announcements.clear();
+}
@@ -0,0 +1,82 @@
+/**********************************
+ * FILE NAME: RendezvousPlacement.cpp
+ *
+ * DESCRIPTION: Definition of the RendezvousPlacement class
+ **********************************/
+
+#include "RendezvousPlacement.h"
+
+/**
+ * Constructor
+ */
+RendezvousPlacement::RendezvousPlacement(size_t replicas): Placement(replicas), best(this->replicas), chosen(this->replicas) {}
+
+/**
+ * FUNCTION NAME: insert
+ *
+ * DESCRIPTION: Add the member
+ */
+void RendezvousPlacement::insert(Address *addr) {
+	for ( size_t i = 0; i < members.size(); i++ ) {
+		if ( members[i] == *addr ) {
+			return;
+		}
+	}
+	members.push_back(*addr);
+	seeds.push_back(hash64(addr->addr, sizeof(addr->addr)));
+}
+
+/**
+ * FUNCTION NAME: remove
+ *
+ * DESCRIPTION: Remove the member. Returns false if it was not a member.
+ */
+bool RendezvousPlacement::remove(Address *addr) {
+	for ( size_t i = 0; i < members.size(); i++ ) {
+		if ( members[i] == *addr ) {
+			members[i] = members.back();
+			members.pop_back();
+			seeds[i] = seeds.back();
+			seeds.pop_back();
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * FUNCTION NAME: size
+ *
+ * DESCRIPTION: Number of members
+ */
+size_t RendezvousPlacement::size() {
+	return members.size();
+}
+
+/**
+ * FUNCTION NAME: replicasOf
+ *
+ * DESCRIPTION: The members with the highest weight for the key, highest first
+ */
+ReplicaSpan RendezvousPlacement::replicasOf(uint64_t position) {
+	if ( members.size() < replicas ) {
+		return ReplicaSpan(NULL, 0);
+	}
+	size_t found = 0;
+	for ( size_t i = 0; i < members.size(); i++ ) {
+		uint64_t weight = mix64(position ^ seeds[i]);
+		if ( found == replicas && weight <= best[replicas - 1] ) {
+			continue;
+		}
+		// Insertion into the top weights, kept in decreasing order
+		size_t r = found < replicas ? found++ : replicas - 1;
+		while ( r > 0 && best[r - 1] < weight ) {
+			best[r] = best[r - 1];
+			chosen[r] = chosen[r - 1];
+			r--;
+		}
+		best[r] = weight;
+		chosen[r] = members[i];
+	}
+	return ReplicaSpan(&chosen[0], replicas);
+}
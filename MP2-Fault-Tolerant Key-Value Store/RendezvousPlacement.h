@@ -0,0 +1,37 @@
+/**********************************
+ * FILE NAME: RendezvousPlacement.h
+ *
+ * DESCRIPTION: Header file of the RendezvousPlacement class
+ **********************************/
+
+#ifndef RENDEZVOUSPLACEMENT_H_
+#define RENDEZVOUSPLACEMENT_H_
+
+#include "Placement.h"
+
+/**
+ * CLASS NAME: RendezvousPlacement
+ *
+ * DESCRIPTION: Rendezvous (highest random weight) hashing. Every member gets a pseudo random
+ * 				weight for every key, the members with the highest weights store it.
+ * 				A membership change only moves the keys of the member that changed, at the
+ * 				price of a lookup linear in the number of members.
+ * 				The span returned by replicasOf points into a buffer reused by the next lookup.
+ */
+class RendezvousPlacement : public Placement {
+private:
+	vector<Address> members;
+	// Hash of members[i]
+	vector<uint64_t> seeds;
+	// Top weights of the last lookup and their members
+	vector<uint64_t> best;
+	vector<Address> chosen;
+public:
+	RendezvousPlacement(size_t replicas);
+	void insert(Address *addr);
+	bool remove(Address *addr);
+	size_t size();
+	ReplicaSpan replicasOf(uint64_t position);
+};
+
+#endif /* RENDEZVOUSPLACEMENT_H_ */
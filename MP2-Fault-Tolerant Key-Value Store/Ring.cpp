@@ -0,0 +1,117 @@
+/**********************************
+ * FILE NAME: Ring.cpp
+ *
+ * DESCRIPTION: Definition of the Ring class
+ **********************************/
+
+#include "Ring.h"
+
+/**
+ * Constructor
+ */
+Ring::Ring(size_t replicas, int tokensPerNode): Placement(replicas), tokensPerNode(tokensPerNode < 1 ? 1 : tokensPerNode), members(0) {}
+
+/**
+ * FUNCTION NAME: insert
+ *
+ * DESCRIPTION: Add the tokens of the member to the ring, keeping it sorted by position
+ */
+void Ring::insert(Address *addr) {
+	Node node(*addr);
+	for ( int t = 0; t < tokensPerNode; t++ ) {
+		node.computeHashCode(t);
+		nodes.insert(upper_bound(nodes.begin(), nodes.end(), node), node);
+	}
+	++members;
+	rebuild();
+}
+
+/**
+ * FUNCTION NAME: remove
+ *
+ * DESCRIPTION: Remove the tokens of the member from the ring. Returns false if it was not in it.
+ */
+bool Ring::remove(Address *addr) {
+	vector<Node>::iterator last = nodes.begin();
+	for ( vector<Node>::iterator it = nodes.begin(); it != nodes.end(); ++it ) {
+		if ( !(*it->getAddress() == *addr) ) {
+			*last++ = *it;
+		}
+	}
+	if ( last == nodes.end() ) {
+		return false;
+	}
+	nodes.erase(last, nodes.end());
+	--members;
+	rebuild();
+	return true;
+}
+
+/**
+ * FUNCTION NAME: size
+ *
+ * DESCRIPTION: Number of members on the ring
+ */
+size_t Ring::size() {
+	return members;
+}
+
+/**
+ * FUNCTION NAME: rebuild
+ *
+ * DESCRIPTION: Recompute the positions and the preference lists after the members changed.
+ * 				Walking clockwise from a token, the tokens of members already in the list are
+ * 				skipped, so the replicas of a key are always distinct members.
+ */
+void Ring::rebuild() {
+	size_t n = nodes.size();
+	tokens.resize(n);
+	preference.resize(n * replicas);
+	for ( size_t i = 0; i < n; i++ ) {
+		tokens[i] = nodes[i].getHashCode();
+	}
+	if ( members < replicas ) {
+		return;
+	}
+	for ( size_t i = 0; i < n; i++ ) {
+		successors(&preference[i * replicas], 0, i);
+	}
+}
+
+/**
+ * FUNCTION NAME: successors
+ *
+ * DESCRIPTION: Complete the preference list holding found members with the members of the
+ * 				tokens clockwise from token start, skipping the members already in the list
+ */
+void Ring::successors(Address *list, size_t found, size_t start) {
+	size_t n = nodes.size();
+	for ( size_t j = start; found < replicas; j = (j + 1) % n ) {
+		Address *addr = nodes[j].getAddress();
+		size_t r = 0;
+		while ( r < found && !(list[r] == *addr) ) {
+			r++;
+		}
+		if ( r == found ) {
+			list[found++] = *addr;
+		}
+	}
+}
+
+/**
+ * FUNCTION NAME: replicasOf
+ *
+ * DESCRIPTION: Preference list of the given position: the first member at or after it, wrapping
+ * 				around to the first member, followed by its successors. Empty while the ring has
+ * 				fewer members than replicas.
+ */
+ReplicaSpan Ring::replicasOf(uint64_t position) {
+	if ( members < replicas ) {
+		return ReplicaSpan(NULL, 0);
+	}
+	size_t i = lower_bound(tokens.begin(), tokens.end(), position) - tokens.begin();
+	if ( i == tokens.size() ) {
+		i = 0;
+	}
+	return ReplicaSpan(&preference[i * replicas], replicas);
+}
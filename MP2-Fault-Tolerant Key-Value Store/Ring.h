@@ -0,0 +1,46 @@
+/**********************************
+ * FILE NAME: Ring.h
+ *
+ * DESCRIPTION: Header file of the Ring class
+ **********************************/
+
+#ifndef RING_H_
+#define RING_H_
+
+#include "stdincludes.h"
+#include "Placement.h"
+
+/**
+ * CLASS NAME: Ring
+ *
+ * DESCRIPTION: Consistent hashing ring. Every member owns a number of virtual tokens, spread
+ * 				over the ring so that the key ranges even out and the range of a failed member
+ * 				is split among many successors. The tokens are kept sorted by position, with
+ * 				their positions in a separate array that lookups binary search, and the
+ * 				preference list of every segment (the member owning it and the next replicas-1
+ * 				distinct members clockwise) is precomputed whenever the ring changes. Looking up
+ * 				the replicas of a key does not allocate.
+ */
+class Ring : public Placement {
+protected:
+	// Virtual tokens per member
+	int tokensPerNode;
+	// Number of distinct members
+	size_t members;
+	// Tokens sorted by position
+	vector<Node> nodes;
+	// Position of nodes[i]
+	vector<uint64_t> tokens;
+	// Preference list of the segment ending at nodes[i], at preference[i*replicas]
+	vector<Address> preference;
+	virtual void rebuild();
+	void successors(Address *list, size_t found, size_t start);
+public:
+	Ring(size_t replicas, int tokensPerNode);
+	void insert(Address *addr);
+	bool remove(Address *addr);
+	size_t size();
+	ReplicaSpan replicasOf(uint64_t position);
+};
+
+#endif /* RING_H_ */
@@ -0,0 +1,145 @@
+/**********************************
+ * FILE NAME: TimerWheel.cpp
+ *
+ * DESCRIPTION: Definition of the hierarchical timer wheel
+ **********************************/
+
+#include "TimerWheel.h"
+
+/**
+ * Constructor
+ */
+TimerWheel::TimerWheel(): now(0) {}
+
+/**
+ * FUNCTION NAME: place
+ *
+ * DESCRIPTION: Move the list node of a timer into the slot its deadline falls in,
+ * 				relative to the current time of the wheel. Timers due before earliest
+ * 				are placed at earliest.
+ */
+void TimerWheel::place(Timer &timer, long earliest) {
+	long deadline = timer.deadline < earliest ? earliest : timer.deadline;
+	int level = 0;
+	long block = deadline;
+
+	if ( deadline - now >= WHEEL_SLOTS ) {
+		for ( level = 1; level < WHEEL_LEVELS; level++ ) {
+			block = deadline >> (WHEEL_BITS * level);
+			if ( block - (now >> (WHEEL_BITS * level)) < WHEEL_SLOTS ) {
+				break;
+			}
+		}
+		if ( level == WHEEL_LEVELS ) {
+			// Beyond the horizon: park it in the furthest slot, it is re-placed when it cascades
+			level = WHEEL_LEVELS - 1;
+			block = (now >> (WHEEL_BITS * level)) + WHEEL_SLOTS - 1;
+		}
+	}
+
+	Slot *target = &slots[level][block & (WHEEL_SLOTS - 1)];
+	target->splice(target->end(), *timer.slot, timer.pos);
+	timer.slot = target;
+}
+
+/**
+ * FUNCTION NAME: cascade
+ *
+ * DESCRIPTION: Re-place the timers of the current slot of a higher level into the levels below
+ */
+void TimerWheel::cascade(int level) {
+	Slot &slot = slots[level][(now >> (WHEEL_BITS * level)) & (WHEEL_SLOTS - 1)];
+	while ( !slot.empty() ) {
+		place(timers.find(slot.front())->second, now);
+	}
+}
+
+/**
+ * FUNCTION NAME: schedule
+ *
+ * DESCRIPTION: Schedule the timer of key to expire at deadline, replacing any earlier schedule
+ */
+void TimerWheel::schedule(unsigned long long key, long deadline) {
+	unordered_map<unsigned long long, Timer>::iterator it = timers.find(key);
+	if ( it == timers.end() ) {
+		if ( spare.empty() ) {
+			spare.push_back(key);
+		}
+		Timer timer;
+		timer.slot = &spare;
+		timer.pos = spare.begin();
+		*timer.pos = key;
+		it = timers.emplace(key, timer).first;
+	}
+	it->second.deadline = deadline;
+	// The slot of the current tick has been processed already
+	place(it->second, now + 1);
+}
+
+/**
+ * FUNCTION NAME: cancel
+ *
+ * DESCRIPTION: Cancel the timer of key, if any
+ */
+void TimerWheel::cancel(unsigned long long key) {
+	unordered_map<unsigned long long, Timer>::iterator it = timers.find(key);
+	if ( it == timers.end() ) {
+		return;
+	}
+	spare.splice(spare.end(), *it->second.slot, it->second.pos);
+	timers.erase(it);
+}
+
+/**
+ * FUNCTION NAME: advance
+ *
+ * DESCRIPTION: Move the wheel forward to time and append the keys of all timers that
+ * 				expired on the way to expired. Expired timers are removed from the wheel.
+ */
+void TimerWheel::advance(long time, vector<unsigned long long> &expired) {
+	while ( now < time ) {
+		now++;
+		for ( int level = WHEEL_LEVELS - 1; level > 0; level-- ) {
+			if ( (now & ((1L << (WHEEL_BITS * level)) - 1)) == 0 ) {
+				cascade(level);
+			}
+		}
+		Slot &slot = slots[0][now & (WHEEL_SLOTS - 1)];
+		while ( !slot.empty() ) {
+			unsigned long long key = slot.front();
+			unordered_map<unsigned long long, Timer>::iterator it = timers.find(key);
+			if ( it->second.deadline > now ) {
+				// Parked beyond the horizon, not due yet
+				place(it->second, now);
+				continue;
+			}
+			spare.splice(spare.end(), slot, slot.begin());
+			timers.erase(it);
+			expired.push_back(key);
+		}
+	}
+}
+
+/**
+ * FUNCTION NAME: size
+ *
+ * DESCRIPTION: Number of timers in the wheel
+ */
+size_t TimerWheel::size() {
+	return timers.size();
+}
+
+/**
+ * FUNCTION NAME: clear
+ *
+ * DESCRIPTION: Cancel all timers and restart the wheel at time
+ */
+void TimerWheel::clear(long time) {
+	for ( int level = 0; level < WHEEL_LEVELS; level++ ) {
+		for ( int i = 0; i < WHEEL_SLOTS; i++ ) {
+			spare.splice(spare.end(), slots[level][i]);
+		}
+	}
+	timers.clear();
+	now = time;
+}
@@ -0,0 +1,91 @@
+/**********************************
+ * FILE NAME: TombstoneSet.cpp
+ *
+ * DESCRIPTION: Definition of the TombstoneSet class
+ **********************************/
+
+#include "TombstoneSet.h"
+
+/**
+ * Constructor
+ */
+TombstoneSet::TombstoneSet(size_t capacity): capacity(capacity) {}
+
+/**
+ * FUNCTION NAME: evict
+ *
+ * DESCRIPTION: Drop the oldest tombstone
+ */
+void TombstoneSet::evict() {
+	unordered_map<unsigned long long, Tombstone>::iterator it = tombstones.find(order.front().first);
+	// The key may have been buried again since, in which case this is an outdated record
+	if ( it != tombstones.end() && it->second.expires == order.front().second ) {
+		tombstones.erase(it);
+	}
+	order.pop_front();
+}
+
+/**
+ * FUNCTION NAME: add
+ *
+ * DESCRIPTION: Bury the given incarnation of a member until expires
+ */
+void TombstoneSet::add(unsigned long long key, long incarnation, long expires) {
+	Tombstone tombstone;
+	tombstone.incarnation = incarnation;
+	tombstone.expires = expires;
+	tombstones[key] = tombstone;
+	order.push_back(make_pair(key, expires));
+	while ( tombstones.size() > capacity ) {
+		evict();
+	}
+}
+
+/**
+ * FUNCTION NAME: buries
+ *
+ * DESCRIPTION: Returns true if the given incarnation of a member has been removed
+ */
+bool TombstoneSet::buries(unsigned long long key, long incarnation) {
+	unordered_map<unsigned long long, Tombstone>::iterator it = tombstones.find(key);
+	return it != tombstones.end() && incarnation <= it->second.incarnation;
+}
+
+/**
+ * FUNCTION NAME: remove
+ *
+ * DESCRIPTION: Dig up the tombstone of a member
+ */
+void TombstoneSet::remove(unsigned long long key) {
+	tombstones.erase(key);
+}
+
+/**
+ * FUNCTION NAME: expire
+ *
+ * DESCRIPTION: Drop all tombstones that expired by now
+ */
+void TombstoneSet::expire(long now) {
+	while ( !order.empty() && order.front().second <= now ) {
+		evict();
+	}
+}
+
+/**
+ * FUNCTION NAME: size
+ *
+ * DESCRIPTION: Number of tombstones
+ */
+size_t TombstoneSet::size() {
+	return tombstones.size();
+}
+
+/**
+ * FUNCTION NAME: clear
+ *
+ * DESCRIPTION: Drop all tombstones
+ */
+void TombstoneSet::clear() {
+	tombstones.clear();
+	order.clear();
+}
@@ -0,0 +1,41 @@
+/**********************************
+ * FILE NAME: TombstoneSet.h
+ *
+ * DESCRIPTION: Header file of the TombstoneSet class
+ **********************************/
+
+#ifndef TOMBSTONESET_H_
+#define TOMBSTONESET_H_
+
+#include "stdincludes.h"
+
+/**
+ * CLASS NAME: TombstoneSet
+ *
+ * DESCRIPTION: Bounded set of recently removed members. A tombstone remembers the incarnation
+ * 				a member was removed in, so that stale gossip about that incarnation cannot
+ * 				add the member back. Tombstones expire after a fixed time, and the oldest
+ * 				one is evicted when the set is full.
+ */
+class TombstoneSet {
+private:
+	struct Tombstone {
+		long incarnation;
+		long expires;
+	};
+	unordered_map<unsigned long long, Tombstone> tombstones;
+	// Tombstones in the order they were added, for expiry and eviction
+	deque<pair<unsigned long long, long> > order;
+	size_t capacity;
+	void evict();
+public:
+	TombstoneSet(size_t capacity);
+	void add(unsigned long long key, long incarnation, long expires);
+	bool buries(unsigned long long key, long incarnation);
+	void remove(unsigned long long key);
+	void expire(long now);
+	size_t size();
+	void clear();
+};
+
+#endif /* TOMBSTONESET_H_ */
@@ -8,7 +8,8 @@
 static int g_transID = 0;
 
 // message types, reply is the message from node to coordinator
-enum MessageType {CREATE, READ, UPDATE, DELETE, REPLY, READREPLY};
+// SYNCROOTS, SYNCLEAVES and SYNCPULL are the anti-entropy exchange between replicas
+enum MessageType {CREATE, READ, UPDATE, DELETE, REPLY, READREPLY, SYNCROOTS, SYNCLEAVES, SYNCPULL};
 // enum of replica types
 enum ReplicaType {PRIMARY, SECONDARY, TERTIARY};
 